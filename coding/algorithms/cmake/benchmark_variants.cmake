@@ -0,0 +1,94 @@
+# Copyright (c) 2023, Piotr Staniszewski
+
+# Benchmark numbers are meaningful only for optimized code, so a benchmark executable
+# is built in several variants, all linked with Google Benchmark:
+#   <name>               -O2 (-O3 with BENCHMARK_OPT_LEVEL)
+#   <name>_O3            -O3
+#   <name>_lto           -O3 with link time optimization
+#   <name>_pgo_generate  -O3 instrumented for profiling (not built by default)
+#   <name>_pgo           -O3 optimized with the profile gathered by running <name>_pgo_generate
+#                        (not built by default, build it with: cmake --build . --target <name>_pgo,
+#                        add --clean-first to pick up a new profile)
+#
+# Usage: add_benchmark_variants(<name> SOURCES <sources...> INCLUDE_DIRS <dirs...>)
+
+# Script mode: GCC names profiles after object files, which differ between the instrumented
+# and the optimized target, so profiles are renamed after gathering
+if(CMAKE_SCRIPT_MODE_FILE)
+    file(GLOB PROFILES ${PGO_DIR}/*.gcda)
+    foreach(PROFILE ${PROFILES})
+        string(REPLACE "_pgo_generate.dir#" "_pgo.dir#" RENAMED_PROFILE ${PROFILE})
+        file(RENAME ${PROFILE} ${RENAMED_PROFILE})
+    endforeach()
+    return()
+endif()
+
+set(BENCHMARK_VARIANTS_SCRIPT ${CMAKE_CURRENT_LIST_FILE})
+
+include(CMakeParseArguments)
+
+if(NOT CMAKE_BUILD_TYPE AND NOT CMAKE_CONFIGURATION_TYPES)
+    set(CMAKE_BUILD_TYPE Release CACHE STRING "Build type" FORCE)
+endif()
+
+set(BENCHMARK_OPT_LEVEL -O2 CACHE STRING "Optimization level of the default benchmark target")
+option(BENCHMARK_NATIVE "Optimize benchmarks for the host CPU (-march=native)" OFF)
+set(BENCHMARK_PGO_ARGS --benchmark_min_time=0.1 CACHE STRING "Arguments of the profiling run for PGO")
+
+find_package(benchmark REQUIRED)
+find_package(Threads REQUIRED)
+
+function(add_benchmark_variant NAME OPT_LEVEL)
+    cmake_parse_arguments(ARG "EXCLUDE_FROM_ALL" "" "SOURCES;INCLUDE_DIRS;FLAGS" ${ARGN})
+
+    if(ARG_EXCLUDE_FROM_ALL)
+        add_executable(${NAME} EXCLUDE_FROM_ALL ${ARG_SOURCES})
+    else()
+        add_executable(${NAME} ${ARG_SOURCES})
+    endif()
+
+    target_include_directories(${NAME} PUBLIC ${ARG_INCLUDE_DIRS})
+
+    target_compile_options(${NAME} PUBLIC -Wall -Wextra -pedantic ${OPT_LEVEL} ${ARG_FLAGS})
+    if(BENCHMARK_NATIVE)
+        target_compile_options(${NAME} PUBLIC -march=native)
+    endif()
+    target_compile_features(${NAME} PUBLIC cxx_std_20)
+
+    target_link_libraries(${NAME} benchmark::benchmark Threads::Threads ${ARG_FLAGS})
+endfunction()
+
+function(add_benchmark_variants NAME)
+    cmake_parse_arguments(ARG "" "" "SOURCES;INCLUDE_DIRS" ${ARGN})
+
+    set(COMMON_ARGS SOURCES ${ARG_SOURCES} INCLUDE_DIRS ${ARG_INCLUDE_DIRS})
+
+    add_benchmark_variant(${NAME} ${BENCHMARK_OPT_LEVEL} ${COMMON_ARGS})
+    add_benchmark_variant(${NAME}_O3 -O3 ${COMMON_ARGS})
+    add_benchmark_variant(${NAME}_lto -O3 ${COMMON_ARGS} FLAGS -flto)
+
+    # Profile guided optimization: instrumented build is run once, its profile used by the final build
+    set(PGO_DIR ${CMAKE_CURRENT_BINARY_DIR}/${NAME}_pgo_profile)
+    set(PGO_STAMP ${PGO_DIR}/profile.stamp)
+    # Identifiers of static functions are otherwise hashed from the object file name
+    set(PGO_ID_FLAGS --param=profile-func-internal-id=1)
+
+    add_benchmark_variant(${NAME}_pgo_generate -O3 EXCLUDE_FROM_ALL ${COMMON_ARGS} FLAGS -fprofile-generate=${PGO_DIR} ${PGO_ID_FLAGS})
+
+    add_custom_command(
+        OUTPUT ${PGO_STAMP}
+        COMMAND ${CMAKE_COMMAND} -E remove_directory ${PGO_DIR}
+        COMMAND ${CMAKE_COMMAND} -E make_directory ${PGO_DIR}
+        COMMAND ${NAME}_pgo_generate ${BENCHMARK_PGO_ARGS}
+        COMMAND ${CMAKE_COMMAND} -DPGO_DIR=${PGO_DIR} -P ${BENCHMARK_VARIANTS_SCRIPT}
+        COMMAND ${CMAKE_COMMAND} -E touch ${PGO_STAMP}
+        DEPENDS ${NAME}_pgo_generate
+        COMMENT "Gathering profile of ${NAME}"
+        VERBATIM
+    )
+
+    add_custom_target(${NAME}_pgo_profile DEPENDS ${PGO_STAMP})
+
+    add_benchmark_variant(${NAME}_pgo -O3 EXCLUDE_FROM_ALL ${COMMON_ARGS} FLAGS -fprofile-use=${PGO_DIR} ${PGO_ID_FLAGS})
+    add_dependencies(${NAME}_pgo ${NAME}_pgo_profile)
+endfunction()
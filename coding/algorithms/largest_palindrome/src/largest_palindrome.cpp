@@ -1,6 +1,8 @@
 // Copyright (c) 2023, Piotr Staniszewski
 
 #include "palindrome_number.hpp"
+#include "palindrome_products.hpp"
+#include "palindrome_table.hpp"
 
 #include <benchmark/benchmark.h>
 
@@ -8,20 +10,19 @@
 #include <tuple>
 
 constexpr uint64_t MAX_N_DIGIT_NUMBER = 999U;
-constexpr uint64_t MAX_PRODUCT_OF_N_DIGIT_NUMBER = MAX_N_DIGIT_NUMBER * MAX_N_DIGIT_NUMBER;
 
 // Calculating all possibilities
-template <typename PalindromeFun>
-auto brute_force(PalindromeFun &&check_palindrome)
+template <typename T = uint64_t, typename PalindromeFun>
+auto brute_force(PalindromeFun &&check_palindrome, T max_number = MAX_N_DIGIT_NUMBER)
 {
-    std::tuple<uint64_t, uint64_t, uint64_t> result = std::make_tuple(0U, 0U, 0U);
+    std::tuple<T, T, T> result = std::make_tuple(T{0U}, T{0U}, T{0U});
     auto& largest_palindrome = std::get<0>(result);
 
-    uint64_t number1 = MAX_N_DIGIT_NUMBER;
+    T number1 = max_number;
 
     while (number1 > 0U)
     {
-        uint64_t number2 = MAX_N_DIGIT_NUMBER;
+        T number2 = max_number;
         while (number2 > 0U)
         {
             auto product = number1 * number2;
@@ -43,17 +44,17 @@ auto brute_force(PalindromeFun &&check_palindrome)
 }
 
 // Calculating all possibilities but skipping decrementing number2 after finding first palindrome
-template <typename PalindromeFun>
-auto brute_force_better(PalindromeFun &&check_palindrome)
+template <typename T = uint64_t, typename PalindromeFun>
+auto brute_force_better(PalindromeFun &&check_palindrome, T max_number = MAX_N_DIGIT_NUMBER)
 {
-    std::tuple<uint64_t, uint64_t, uint64_t> result = std::make_tuple(0U, 0U, 0U);
+    std::tuple<T, T, T> result = std::make_tuple(T{0U}, T{0U}, T{0U});
     auto& largest_palindrome = std::get<0>(result);
 
-    uint64_t number1 = MAX_N_DIGIT_NUMBER;
+    T number1 = max_number;
 
     while (number1 > 0U)
     {
-        uint64_t number2 = MAX_N_DIGIT_NUMBER;
+        T number2 = max_number;
         while (number2 > 0U)
         {
             auto product = number1 * number2;
@@ -78,23 +79,23 @@ auto brute_force_better(PalindromeFun &&check_palindrome)
 }
 
 // First idea of solving the problem
-template <typename PalindromeFun>
-auto first_idea(PalindromeFun &&check_palindrome)
+template <typename T = uint64_t, typename PalindromeFun>
+auto first_idea(PalindromeFun &&check_palindrome, T max_number = MAX_N_DIGIT_NUMBER)
 {
     bool found{false};
-    std::tuple<uint64_t, uint64_t, uint64_t> result = std::make_tuple(0U, 0U, 0U);
+    std::tuple<T, T, T> result = std::make_tuple(T{0U}, T{0U}, T{0U});
 
-    uint64_t n = MAX_PRODUCT_OF_N_DIGIT_NUMBER;
+    T n = max_number * max_number;
     while (n > 0)
     {
         if (check_palindrome(n))
         {
-            uint64_t number1 = MAX_N_DIGIT_NUMBER;
+            T number1 = max_number;
             while (number1 > 0U)
             {
-                const uint64_t number2 = n / number1;
+                const T number2 = n / number1;
 
-                if (number2 > MAX_N_DIGIT_NUMBER)
+                if (number2 > max_number)
                 {
                     break;
                 }
@@ -124,6 +125,7 @@ static void benchmark_brute_force(benchmark::State &state)
     for (auto _ : state)
     {
         std::tuple<uint64_t, uint64_t, uint64_t> result = brute_force(is_palindrome<uint64_t>);
+        benchmark::DoNotOptimize(result);
         // std::cout << std::get<0>(result) << " = " << std::get<1>(result) << " * " << std::get<2>(result) << std::endl;
     }
 }
@@ -134,6 +136,7 @@ static void benchmark_brute_force_better(benchmark::State &state)
     for (auto _ : state)
     {
         std::tuple<uint64_t, uint64_t, uint64_t> result = brute_force_better(is_palindrome<uint64_t>);
+        benchmark::DoNotOptimize(result);
         // std::cout << std::get<0>(result) << " = " << std::get<1>(result) << " * " << std::get<2>(result) << std::endl;
     }
 }
@@ -144,19 +147,106 @@ static void benchmark_first_idea(benchmark::State &state)
     for (auto _ : state)
     {
         std::tuple<uint64_t, uint64_t, uint64_t> result = first_idea(is_palindrome<uint64_t>);
+        benchmark::DoNotOptimize(result);
         // std::cout << std::get<0>(result) << " = " << std::get<1>(result) << " * " << std::get<2>(result) << std::endl;
     }
 }
 BENCHMARK(benchmark_first_idea);
 
+static void benchmark_mirrored_half(benchmark::State &state)
+{
+    unsigned digits = 3U;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(digits);
+        Palindrome_product result = mirrored_half(digits);
+        benchmark::DoNotOptimize(result);
+    }
+}
+BENCHMARK(benchmark_mirrored_half);
+
+// Answer precomputed at compile time
+static void benchmark_palindrome_table(benchmark::State &state)
+{
+    unsigned digits = 3U;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(digits);
+        Palindrome_product result = largest_palindrome_product(digits);
+        benchmark::DoNotOptimize(result);
+    }
+}
+BENCHMARK(benchmark_palindrome_table);
+
 static void benchmark_is_palindrome(benchmark::State &state)
 {
+    int number = 9990999;
     for (auto _ : state)
     {
-        is_palindrome(9990999);
-        // std::cout << std::get<0>(result) << " = " << std::get<1>(result) << " * " << std::get<2>(result) << std::endl;
+        // Number hidden from the optimizer, otherwise the constexpr call is folded away
+        benchmark::DoNotOptimize(number);
+        bool palindrome = is_palindrome(number);
+        benchmark::DoNotOptimize(palindrome);
     }
 }
 BENCHMARK(benchmark_is_palindrome);
 
+// Same search with 128-bit arithmetic, cost of the wider type
+static void benchmark_first_idea_uint128(benchmark::State &state)
+{
+    for (auto _ : state)
+    {
+        std::tuple<uint128_t, uint128_t, uint128_t> result = first_idea(is_palindrome<uint128_t>, uint128_t{MAX_N_DIGIT_NUMBER});
+        benchmark::DoNotOptimize(result);
+    }
+}
+BENCHMARK(benchmark_first_idea_uint128);
+
+// Checks a range of consecutive numbers, throughput per base and type
+template <typename T, unsigned BASE>
+static void benchmark_is_palindrome_base(benchmark::State &state)
+{
+    T first_number = 999000000U;
+    constexpr T numbers = 1000U;
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(first_number);
+        unsigned palindromes{0U};
+        for (T number = first_number; number < first_number + numbers; ++number)
+        {
+            palindromes += is_palindrome<T, BASE>(number);
+        }
+        benchmark::DoNotOptimize(palindromes);
+    }
+    state.SetItemsProcessed(state.iterations() * numbers);
+}
+BENCHMARK_TEMPLATE(benchmark_is_palindrome_base, uint64_t, 2U);
+BENCHMARK_TEMPLATE(benchmark_is_palindrome_base, uint64_t, 8U);
+BENCHMARK_TEMPLATE(benchmark_is_palindrome_base, uint64_t, 10U);
+BENCHMARK_TEMPLATE(benchmark_is_palindrome_base, uint64_t, 16U);
+BENCHMARK_TEMPLATE(benchmark_is_palindrome_base, uint128_t, 2U);
+BENCHMARK_TEMPLATE(benchmark_is_palindrome_base, uint128_t, 10U);
+
+// Bulk queries: all palindromic products of 3-digit numbers, argument is number of threads
+static void benchmark_count_palindromic_pairs(benchmark::State &state)
+{
+    for (auto _ : state)
+    {
+        uint64_t count = count_palindromic_pairs(uint64_t{100U}, MAX_N_DIGIT_NUMBER, static_cast<unsigned>(state.range(0)));
+        benchmark::DoNotOptimize(count);
+    }
+}
+BENCHMARK(benchmark_count_palindromic_pairs)->Arg(1)->Arg(2)->Arg(4)->UseRealTime();
+
+static void benchmark_count_palindromic_products(benchmark::State &state)
+{
+    for (auto _ : state)
+    {
+        uint64_t count = count_palindromic_products(uint64_t{100U}, MAX_N_DIGIT_NUMBER, static_cast<unsigned>(state.range(0)));
+        benchmark::DoNotOptimize(count);
+    }
+}
+BENCHMARK(benchmark_count_palindromic_products)->Arg(1)->Arg(2)->Arg(4)->UseRealTime();
+
 BENCHMARK_MAIN();
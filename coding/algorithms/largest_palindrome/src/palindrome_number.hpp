@@ -1,18 +1,195 @@
 #pragma once
 
+#include <bit>
+#include <climits>
+#include <cstdint>
 #include <type_traits>
 
-template <typename T>
+// 128-bit integers, for products of numbers with more than 9 digits
+__extension__ typedef unsigned __int128 uint128_t;
+__extension__ typedef __int128 int128_t;
+
+namespace detail
+{
+    // std::is_integral doesn't know __int128 in strict ISO mode
+    template <typename T>
+    struct is_integer : std::is_integral<T>
+    {
+    };
+
+    template <>
+    struct is_integer<int128_t> : std::true_type
+    {
+    };
+
+    template <>
+    struct is_integer<uint128_t> : std::true_type
+    {
+    };
+
+    template <typename T>
+    struct to_unsigned : std::make_unsigned<T>
+    {
+    };
+
+    template <>
+    struct to_unsigned<int128_t>
+    {
+        using type = uint128_t;
+    };
+
+    template <>
+    struct to_unsigned<uint128_t>
+    {
+        using type = uint128_t;
+    };
+
+    template <typename T>
+    using to_unsigned_t = typename to_unsigned<T>::type;
+
+    constexpr bool is_power_of_two(unsigned value) noexcept
+    {
+        return value != 0U && (value & (value - 1U)) == 0U;
+    }
+
+    constexpr unsigned log2(unsigned value) noexcept
+    {
+        return static_cast<unsigned>(std::bit_width(value)) - 1U;
+    }
+
+    template <typename U>
+    constexpr unsigned bit_width(U value) noexcept
+    {
+        if constexpr (sizeof(U) > sizeof(uint64_t))
+        {
+            const auto high = static_cast<uint64_t>(value >> 64);
+            if (high != 0U)
+            {
+                return 64U + static_cast<unsigned>(std::bit_width(high));
+            }
+        }
+        return static_cast<unsigned>(std::bit_width(static_cast<uint64_t>(value)));
+    }
+
+    // Reverses order of DIGIT_BITS-wide groups of bits (swapping halves, quarters, ... down to a digit)
+    template <unsigned DIGIT_BITS>
+    constexpr uint64_t reverse_digits(uint64_t value) noexcept
+    {
+        if constexpr (DIGIT_BITS <= 1U)
+            value = ((value >> 1) & 0x5555555555555555U) | ((value & 0x5555555555555555U) << 1);
+        if constexpr (DIGIT_BITS <= 2U)
+            value = ((value >> 2) & 0x3333333333333333U) | ((value & 0x3333333333333333U) << 2);
+        if constexpr (DIGIT_BITS <= 4U)
+            value = ((value >> 4) & 0x0F0F0F0F0F0F0F0FU) | ((value & 0x0F0F0F0F0F0F0F0FU) << 4);
+        if constexpr (DIGIT_BITS <= 8U)
+            value = ((value >> 8) & 0x00FF00FF00FF00FFU) | ((value & 0x00FF00FF00FF00FFU) << 8);
+        if constexpr (DIGIT_BITS <= 16U)
+            value = ((value >> 16) & 0x0000FFFF0000FFFFU) | ((value & 0x0000FFFF0000FFFFU) << 16);
+        return (value >> 32) | (value << 32);
+    }
+
+    template <unsigned DIGIT_BITS>
+    constexpr uint128_t reverse_digits(uint128_t value) noexcept
+    {
+        const auto low = reverse_digits<DIGIT_BITS>(static_cast<uint64_t>(value));
+        const auto high = reverse_digits<DIGIT_BITS>(static_cast<uint64_t>(value >> 64));
+        return (static_cast<uint128_t>(low) << 64) | high;
+    }
+
+    // Base 2^k: digits are extracted with shifts and masks, no division needed
+    template <unsigned BASE, typename U>
+    constexpr bool is_palindrome_pow2(U number) noexcept
+    {
+        constexpr unsigned digit_bits = log2(BASE);
+
+        if (number == 0U)
+        {
+            return true;
+        }
+
+        const unsigned digits = (bit_width(number) + digit_bits - 1U) / digit_bits;
+
+        if constexpr (is_power_of_two(digit_bits) && digit_bits < 64U)
+        {
+            // Whole number reversed at once, digits shifted back to the bottom
+            using Wide = std::conditional_t<(sizeof(U) > sizeof(uint64_t)), uint128_t, uint64_t>;
+            constexpr unsigned wide_bits = sizeof(Wide) * CHAR_BIT;
+
+            const Wide wide_number = number;
+            return (reverse_digits<digit_bits>(wide_number) >> (wide_bits - digits * digit_bits)) == wide_number;
+        }
+        else
+        {
+            // Digits compared from both ends, stops at first difference
+            constexpr U mask = BASE - 1U;
+
+            unsigned low = 0U;
+            unsigned high = (digits - 1U) * digit_bits;
+            while (low < high)
+            {
+                if (((number >> low) & mask) != ((number >> high) & mask))
+                {
+                    return false;
+                }
+                low += digit_bits;
+                high -= digit_bits;
+            }
+            return true;
+        }
+    }
+
+    // Any base: only the lower half of digits is reversed, so the reversed value can't overflow
+    template <unsigned BASE, typename U>
+    constexpr bool is_palindrome_generic(U number) noexcept
+    {
+        if constexpr (sizeof(U) > sizeof(uint64_t))
+        {
+            // 128-bit division is a library call, switch to 64-bit as soon as the number fits
+            if ((number >> 64) == 0U)
+            {
+                return is_palindrome_generic<BASE>(static_cast<uint64_t>(number));
+            }
+        }
+
+        if (number % BASE == 0U)
+        {
+            return number == 0U;
+        }
+
+        U rev_number = 0U;
+        while (number > rev_number)
+        {
+            rev_number = rev_number * BASE + number % BASE;
+            number = number / BASE;
+        }
+
+        // Odd number of digits: the middle one ends in rev_number
+        return number == rev_number || number == rev_number / BASE;
+    }
+}
+
+template <typename T, unsigned BASE = 10U>
 constexpr bool is_palindrome(T number)
 {
-    static_assert(std::is_integral<T>::value, "Integral type required.");
-    const T orig_number = number;
+    static_assert(detail::is_integer<T>::value, "Integral type required.");
+    static_assert(BASE >= 2U, "Base of at least 2 required.");
+
+    // Negative numbers are not palindromes
+    if constexpr (static_cast<T>(-1) < static_cast<T>(0))
+    {
+        if (number < 0)
+        {
+            return false;
+        }
+    }
 
-    T rev_number = 0;
-    while (number > 0)
+    using U = detail::to_unsigned_t<T>;
+    if constexpr (detail::is_power_of_two(BASE))
+    {
+        return detail::is_palindrome_pow2<BASE>(static_cast<U>(number));
+    }
+    else
     {
-        rev_number = rev_number * 10 + number % 10;
-        number = number / 10;
+        return detail::is_palindrome_generic<BASE>(static_cast<U>(number));
     }
-    return rev_number == orig_number;
 }
@@ -0,0 +1,279 @@
+#pragma once
+
+#include "palindrome_number.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+// Enumeration of all palindromic products of two numbers from [min, max] (instead of the largest one only).
+// Results are streamed to a callback, max * max has to fit in T (std::out_of_range otherwise).
+
+namespace detail
+{
+    // Products marked at once in a bitmap, 32 KiB of bits
+    constexpr uint64_t SIEVE_BLOCK_SIZE = uint64_t{1U} << 18;
+
+    template <typename T>
+    T ceil_div(T dividend, T divisor)
+    {
+        return dividend / divisor + (dividend % divisor != 0U ? 1U : 0U);
+    }
+
+    template <typename T>
+    T isqrt(T number)
+    {
+        T root = static_cast<T>(std::sqrt(static_cast<long double>(number)));
+        while (root > 0U && root > number / root)
+        {
+            --root;
+        }
+        while (root + 1U <= number / (root + 1U))
+        {
+            ++root;
+        }
+        return root;
+    }
+
+    // Marks products number1 * number2 (number1 <= number2) falling into [first, last], then reports the palindromic
+    // ones in ascending order; each product is checked once, no matter how many pairs of factors it has
+    template <unsigned BASE, typename T, typename Callback>
+    void sieve_block(T min, T max, T first, T last, std::vector<uint64_t> &bitmap, Callback &callback)
+    {
+        std::fill(bitmap.begin(), bitmap.end(), 0U);
+
+        const T number1_last = std::min(max, isqrt(last));
+        for (T number1 = std::max(min, ceil_div(first, max)); number1 <= number1_last; ++number1)
+        {
+            const T number2_first = std::max(number1, ceil_div(first, number1));
+            const T number2_last = std::min(max, last / number1);
+            if (number2_first > number2_last)
+            {
+                continue;
+            }
+
+            const T product_last = number1 * number2_last;
+            for (T product = number1 * number2_first; product <= product_last; product += number1)
+            {
+                const auto offset = static_cast<uint64_t>(product - first);
+                bitmap[offset / 64U] |= uint64_t{1U} << (offset % 64U);
+            }
+        }
+
+        for (size_t word = 0U; word < bitmap.size(); ++word)
+        {
+            uint64_t bits = bitmap[word];
+            while (bits != 0U)
+            {
+                const T product = first + static_cast<T>(word * 64U + std::countr_zero(bits));
+                if (is_palindrome<T, BASE>(product))
+                {
+                    callback(product);
+                }
+                bits &= bits - 1U;
+            }
+        }
+    }
+
+    // Pairs with number1 = first, first + step, ...
+    template <unsigned BASE, typename T, typename Callback>
+    void pairs_strided(T first, T max, T step, Callback &callback)
+    {
+        for (T number1 = first; number1 <= max; number1 += step)
+        {
+            T product = number1 * number1;
+            for (T number2 = number1; number2 <= max; ++number2, product += number1)
+            {
+                if (is_palindrome<T, BASE>(product))
+                {
+                    callback(product, number1, number2);
+                }
+            }
+
+            if (max - number1 < step)
+            {
+                break;
+            }
+        }
+    }
+
+    template <typename T>
+    void check_max(T max)
+    {
+        if (max > isqrt(std::numeric_limits<T>::max()))
+        {
+            throw std::out_of_range("Square of max doesn't fit the type");
+        }
+    }
+
+    // Last product of the block starting at first, without going past T
+    template <typename T>
+    T block_last(T first, T last_product)
+    {
+        return last_product - first < SIEVE_BLOCK_SIZE ? last_product : static_cast<T>(first + (SIEVE_BLOCK_SIZE - 1U));
+    }
+
+    inline unsigned threads_or_default(unsigned threads)
+    {
+        return threads > 0U ? threads : std::max(std::thread::hardware_concurrency(), 1U);
+    }
+}
+
+// Calls callback(product, number1, number2) for each pair number1 <= number2 with palindromic product,
+// ordered by number1, then number2
+template <unsigned BASE = 10U, typename T, typename Callback>
+void for_each_palindromic_pair(T min, T max, Callback &&callback)
+{
+    detail::check_max(max);
+    if (min <= max)
+    {
+        detail::pairs_strided<BASE>(min, max, T{1U}, callback);
+    }
+}
+
+// Calls callback(product) once for each distinct palindromic product, in ascending order
+template <unsigned BASE = 10U, typename T, typename Callback>
+void for_each_palindromic_product(T min, T max, Callback &&callback)
+{
+    detail::check_max(max);
+    if (min > max)
+    {
+        return;
+    }
+    if (min == 0U)
+    {
+        callback(T{0U});
+        if (max == 0U)
+        {
+            return;
+        }
+        min = 1U;
+    }
+
+    std::vector<uint64_t> bitmap(detail::SIEVE_BLOCK_SIZE / 64U);
+
+    const T last_product = max * max;
+    for (T first = min * min;; first += detail::SIEVE_BLOCK_SIZE)
+    {
+        const T last = detail::block_last(first, last_product);
+        detail::sieve_block<BASE>(min, max, first, last, bitmap, callback);
+        if (last == last_product)
+        {
+            break;
+        }
+    }
+}
+
+// Parallel versions: callback is called concurrently from many threads (has to be thread safe) and
+// results come in no particular order; threads = 0 means all hardware threads
+
+// Each thread takes every threads-th number1, so long and short rows are spread evenly
+template <unsigned BASE = 10U, typename T, typename Callback>
+void for_each_palindromic_pair_parallel(T min, T max, Callback &&callback, unsigned threads = 0U)
+{
+    detail::check_max(max);
+    if (min > max)
+    {
+        return;
+    }
+
+    threads = detail::threads_or_default(threads);
+
+    std::vector<std::jthread> workers;
+    for (unsigned i = 1U; i < threads && max - min >= i; ++i)
+    {
+        workers.emplace_back([&, i]
+                             { detail::pairs_strided<BASE>(static_cast<T>(min + i), max, static_cast<T>(threads), callback); });
+    }
+    detail::pairs_strided<BASE>(min, max, static_cast<T>(threads), callback);
+}
+
+// Threads take blocks of the sieve one by one, each with its own bitmap
+template <unsigned BASE = 10U, typename T, typename Callback>
+void for_each_palindromic_product_parallel(T min, T max, Callback &&callback, unsigned threads = 0U)
+{
+    detail::check_max(max);
+    if (min > max)
+    {
+        return;
+    }
+    if (min == 0U)
+    {
+        callback(T{0U});
+        if (max == 0U)
+        {
+            return;
+        }
+        min = 1U;
+    }
+
+    threads = detail::threads_or_default(threads);
+
+    const T first_product = min * min;
+    const T last_product = max * max;
+    const auto blocks = static_cast<uint64_t>((last_product - first_product) / detail::SIEVE_BLOCK_SIZE) + 1U;
+
+    std::atomic<uint64_t> next_block{0U};
+    auto worker = [&]
+    {
+        std::vector<uint64_t> bitmap(detail::SIEVE_BLOCK_SIZE / 64U);
+        for (uint64_t block = next_block++; block < blocks; block = next_block++)
+        {
+            const T first = static_cast<T>(first_product + block * detail::SIEVE_BLOCK_SIZE);
+            const T last = detail::block_last(first, last_product);
+            detail::sieve_block<BASE>(min, max, first, last, bitmap, callback);
+        }
+    };
+
+    std::vector<std::jthread> workers;
+    for (unsigned i = 1U; i < threads && i < blocks; ++i)
+    {
+        workers.emplace_back(worker);
+    }
+    worker();
+}
+
+// Counting mode, threads > 1 uses the parallel versions
+template <unsigned BASE = 10U, typename T>
+uint64_t count_palindromic_pairs(T min, T max, unsigned threads = 1U)
+{
+    if (threads == 1U)
+    {
+        uint64_t count{0U};
+        for_each_palindromic_pair<BASE>(min, max, [&count](T, T, T)
+                                        { ++count; });
+        return count;
+    }
+
+    std::atomic<uint64_t> count{0U};
+    for_each_palindromic_pair_parallel<BASE>(
+        min, max, [&count](T, T, T)
+        { count.fetch_add(1U, std::memory_order_relaxed); },
+        threads);
+    return count;
+}
+
+template <unsigned BASE = 10U, typename T>
+uint64_t count_palindromic_products(T min, T max, unsigned threads = 1U)
+{
+    if (threads == 1U)
+    {
+        uint64_t count{0U};
+        for_each_palindromic_product<BASE>(min, max, [&count](T)
+                                           { ++count; });
+        return count;
+    }
+
+    std::atomic<uint64_t> count{0U};
+    for_each_palindromic_product_parallel<BASE>(
+        min, max, [&count](T)
+        { count.fetch_add(1U, std::memory_order_relaxed); },
+        threads);
+    return count;
+}
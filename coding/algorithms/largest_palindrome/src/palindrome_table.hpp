@@ -0,0 +1,117 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <stdexcept>
+
+// Largest palindromes made from the product of two n-digit numbers, precomputed at compile time.
+// Palindromes are generated from the largest down by mirroring their upper half, so only palindromes
+// are checked for factors instead of all products.
+
+struct Palindrome_product
+{
+    uint64_t m_product{0U};
+    uint64_t m_number1{0U};
+    uint64_t m_number2{0U};
+
+    friend constexpr bool operator==(const Palindrome_product &, const Palindrome_product &) = default;
+};
+
+namespace detail
+{
+    constexpr uint64_t power10(unsigned exponent)
+    {
+        uint64_t power = 1U;
+        for (unsigned i = 0U; i < exponent; ++i)
+        {
+            power *= 10U;
+        }
+        return power;
+    }
+
+    // Palindrome with half as upper digits; with odd number of digits the last digit of half is the middle one
+    constexpr uint64_t mirror(uint64_t half, unsigned half_digits, bool odd)
+    {
+        uint64_t lower = odd ? half / 10U : half;
+        uint64_t rev_lower = 0U;
+        for (unsigned i = odd ? 1U : 0U; i < half_digits; ++i)
+        {
+            rev_lower = rev_lower * 10U + lower % 10U;
+            lower /= 10U;
+        }
+        return half * power10(odd ? half_digits - 1U : half_digits) + rev_lower;
+    }
+}
+
+// Product of two numbers of more digits doesn't fit in 64 bits
+constexpr unsigned MAX_PALINDROME_DIGITS = 9U;
+
+// From 1 up to MAX_PALINDROME_DIGITS digits, std::out_of_range otherwise
+constexpr Palindrome_product mirrored_half(unsigned digits)
+{
+    if (digits == 0U || digits > MAX_PALINDROME_DIGITS)
+    {
+        throw std::out_of_range("Number of digits out of range");
+    }
+
+    const uint64_t max = detail::power10(digits) - 1U;
+    const uint64_t min = detail::power10(digits - 1U);
+
+    // 2n digits first, then 2n - 1 digits
+    for (const bool odd : {false, true})
+    {
+        // Palindrome with even number of digits is a multiple of 11 (prime), so one of factors is too
+        const uint64_t step = odd ? 1U : 11U;
+
+        for (uint64_t half = max; half >= min; --half)
+        {
+            const uint64_t palindrome = detail::mirror(half, digits, odd);
+            if (palindrome / max > max)
+            {
+                continue;
+            }
+
+            const uint64_t number_min = (palindrome + max - 1U) / max;
+            for (uint64_t number = max - max % step; number >= number_min && number >= min; number -= step)
+            {
+                if (palindrome % number == 0U)
+                {
+                    const uint64_t other_number = palindrome / number;
+                    return number > other_number ? Palindrome_product{palindrome, number, other_number}
+                                                 : Palindrome_product{palindrome, other_number, number};
+                }
+            }
+        }
+    }
+
+    return Palindrome_product{};
+}
+
+// Number of digits with answers known at compile time
+constexpr unsigned PALINDROME_TABLE_DIGITS = 7U;
+
+template <unsigned DIGITS>
+consteval auto make_palindrome_table()
+{
+    std::array<Palindrome_product, DIGITS + 1U> table{};
+    for (unsigned digits = 1U; digits <= DIGITS; ++digits)
+    {
+        table[digits] = mirrored_half(digits);
+    }
+    return table;
+}
+
+// Indexed by number of digits, index 0 unused
+inline constexpr auto PALINDROME_TABLE = make_palindrome_table<PALINDROME_TABLE_DIGITS>();
+
+static_assert(PALINDROME_TABLE_DIGITS <= MAX_PALINDROME_DIGITS);
+
+// Single load for digits covered by the table, runtime search above
+constexpr Palindrome_product largest_palindrome_product(unsigned digits)
+{
+    if (digits != 0U && digits < PALINDROME_TABLE.size())
+    {
+        return PALINDROME_TABLE[digits];
+    }
+    return mirrored_half(digits);
+}
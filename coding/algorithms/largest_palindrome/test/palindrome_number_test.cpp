@@ -14,3 +14,70 @@ TEST(Palindrome_number, test_is_palindrome)
     EXPECT_TRUE(is_palindrome(9223229));
     EXPECT_TRUE(is_palindrome(55122155));
 }
+
+TEST(Palindrome_number, test_is_palindrome_negative)
+{
+    EXPECT_FALSE(is_palindrome(-1));
+    EXPECT_FALSE(is_palindrome(-121));
+
+    EXPECT_TRUE(is_palindrome(0));
+}
+
+TEST(Palindrome_number, test_is_palindrome_base2)
+{
+    EXPECT_FALSE((is_palindrome<unsigned, 2U>(0b10U)));
+    EXPECT_FALSE((is_palindrome<unsigned, 2U>(0b1101U)));
+    EXPECT_FALSE((is_palindrome<uint64_t, 2U>(0x8000000000000000U)));
+
+    EXPECT_TRUE((is_palindrome<unsigned, 2U>(0b0U)));
+    EXPECT_TRUE((is_palindrome<unsigned, 2U>(0b1U)));
+    EXPECT_TRUE((is_palindrome<unsigned, 2U>(0b1001U)));
+    EXPECT_TRUE((is_palindrome<unsigned, 2U>(0b10101U)));
+    EXPECT_TRUE((is_palindrome<uint64_t, 2U>(0x8000000000000001U)));
+}
+
+TEST(Palindrome_number, test_is_palindrome_power_of_two_bases)
+{
+    EXPECT_FALSE((is_palindrome<unsigned, 8U>(012U)));
+    EXPECT_FALSE((is_palindrome<unsigned, 16U>(0x1234U)));
+    EXPECT_FALSE((is_palindrome<unsigned, 16U>(0x10U)));
+    EXPECT_FALSE((is_palindrome<uint64_t, 256U>(0x0102U)));
+
+    EXPECT_TRUE((is_palindrome<unsigned, 8U>(0121U)));
+    EXPECT_TRUE((is_palindrome<unsigned, 8U>(07557U)));
+    EXPECT_TRUE((is_palindrome<unsigned, 16U>(0xABBAU)));
+    EXPECT_TRUE((is_palindrome<unsigned, 16U>(0xF0FU)));
+    EXPECT_TRUE((is_palindrome<uint64_t, 256U>(0x0102FF0201U)));
+}
+
+TEST(Palindrome_number, test_is_palindrome_other_bases)
+{
+    EXPECT_FALSE((is_palindrome<unsigned, 3U>(3U)));  // 10
+    EXPECT_FALSE((is_palindrome<unsigned, 7U>(51U))); // 102
+
+    EXPECT_TRUE((is_palindrome<unsigned, 3U>(10U)));  // 101
+    EXPECT_TRUE((is_palindrome<unsigned, 7U>(57U)));  // 111
+    EXPECT_TRUE((is_palindrome<unsigned, 36U>(37U))); // 11
+}
+
+TEST(Palindrome_number, test_is_palindrome_uint128)
+{
+    // 12345678900987654321, exceeds 64 bits
+    const uint128_t palindrome = static_cast<uint128_t>(1234567890U) * 10000000000U + 987654321U;
+
+    EXPECT_FALSE(is_palindrome(palindrome + 1U));
+    EXPECT_FALSE(is_palindrome(static_cast<uint128_t>(1U) << 100));
+    EXPECT_FALSE((is_palindrome<uint128_t, 2U>(static_cast<uint128_t>(1U) << 100)));
+
+    EXPECT_TRUE(is_palindrome(palindrome));
+    EXPECT_TRUE(is_palindrome(static_cast<uint128_t>(12321U)));
+    EXPECT_TRUE((is_palindrome<uint128_t, 2U>((static_cast<uint128_t>(1U) << 127) | 1U)));
+    EXPECT_TRUE((is_palindrome<int128_t, 10U>(static_cast<int128_t>(palindrome))));
+}
+
+TEST(Palindrome_number, test_is_palindrome_constexpr)
+{
+    static_assert(is_palindrome(9009));
+    static_assert(is_palindrome<uint64_t, 2U>(0b110011U));
+    static_assert(!is_palindrome<uint128_t, 10U>(10U));
+}
@@ -0,0 +1,142 @@
+#include <palindrome_products.hpp>
+
+#include <gtest/gtest.h>
+
+#include <mutex>
+#include <set>
+#include <tuple>
+
+namespace
+{
+    using Pair = std::tuple<uint64_t, uint64_t, uint64_t>;
+
+    template <unsigned BASE = 10U>
+    std::set<Pair> brute_force_pairs(uint64_t min, uint64_t max)
+    {
+        std::set<Pair> pairs;
+        for (auto number1 = min; number1 <= max; ++number1)
+        {
+            for (auto number2 = number1; number2 <= max; ++number2)
+            {
+                if (is_palindrome<uint64_t, BASE>(number1 * number2))
+                {
+                    pairs.emplace(number1 * number2, number1, number2);
+                }
+            }
+        }
+        return pairs;
+    }
+
+    template <unsigned BASE = 10U>
+    std::set<uint64_t> brute_force_products(uint64_t min, uint64_t max)
+    {
+        std::set<uint64_t> products;
+        for (const auto &pair : brute_force_pairs<BASE>(min, max))
+        {
+            products.insert(std::get<0>(pair));
+        }
+        return products;
+    }
+}
+
+TEST(Palindrome_products, test_for_each_palindromic_pair)
+{
+    std::vector<Pair> pairs;
+    for_each_palindromic_pair(uint64_t{10U}, uint64_t{99U}, [&pairs](uint64_t product, uint64_t number1, uint64_t number2)
+                              { pairs.emplace_back(product, number1, number2); });
+
+    EXPECT_TRUE(std::is_sorted(pairs.begin(), pairs.end(), [](const Pair &lhs, const Pair &rhs)
+                               { return std::tie(std::get<1>(lhs), std::get<2>(lhs)) < std::tie(std::get<1>(rhs), std::get<2>(rhs)); }));
+    EXPECT_EQ(std::set<Pair>(pairs.begin(), pairs.end()), brute_force_pairs(10U, 99U));
+    EXPECT_EQ(pairs.size(), brute_force_pairs(10U, 99U).size());
+}
+
+TEST(Palindrome_products, test_for_each_palindromic_product)
+{
+    std::vector<uint64_t> products;
+    for_each_palindromic_product(uint64_t{10U}, uint64_t{99U}, [&products](uint64_t product)
+                                 { products.push_back(product); });
+
+    ASSERT_FALSE(products.empty());
+    EXPECT_EQ(products.back(), 9009U);
+    EXPECT_TRUE(std::is_sorted(products.begin(), products.end()));
+    EXPECT_EQ(std::set<uint64_t>(products.begin(), products.end()), brute_force_products(10U, 99U));
+    EXPECT_EQ(products.size(), brute_force_products(10U, 99U).size());
+}
+
+TEST(Palindrome_products, test_for_each_palindromic_product_many_blocks)
+{
+    // Products up to ~4 * 10^6, more than one block of the sieve
+    std::vector<uint64_t> products;
+    for_each_palindromic_product(uint64_t{1000U}, uint64_t{2000U}, [&products](uint64_t product)
+                                 { products.push_back(product); });
+
+    EXPECT_TRUE(std::is_sorted(products.begin(), products.end()));
+    EXPECT_EQ(std::set<uint64_t>(products.begin(), products.end()), brute_force_products(1000U, 2000U));
+}
+
+TEST(Palindrome_products, test_for_each_palindromic_product_zero)
+{
+    std::vector<unsigned> products;
+    for_each_palindromic_product(0U, 3U, [&products](unsigned product)
+                                 { products.push_back(product); });
+
+    EXPECT_EQ(products, (std::vector<unsigned>{0U, 1U, 2U, 3U, 4U, 6U, 9U}));
+
+    // Zero alone, nothing left to sieve
+    EXPECT_EQ(count_palindromic_products(uint64_t{0U}, uint64_t{0U}), 1U);
+    EXPECT_EQ(count_palindromic_products(uint64_t{0U}, uint64_t{0U}, 4U), 1U);
+}
+
+TEST(Palindrome_products, test_parallel)
+{
+    std::mutex mutex;
+    std::set<Pair> pairs;
+    for_each_palindromic_pair_parallel(
+        uint64_t{100U}, uint64_t{999U}, [&](uint64_t product, uint64_t number1, uint64_t number2)
+        { std::lock_guard lock{mutex}; pairs.emplace(product, number1, number2); },
+        4U);
+
+    std::set<uint64_t> products;
+    for_each_palindromic_product_parallel(
+        uint64_t{100U}, uint64_t{999U}, [&](uint64_t product)
+        { std::lock_guard lock{mutex}; products.insert(product); },
+        4U);
+
+    EXPECT_EQ(pairs, brute_force_pairs(100U, 999U));
+    EXPECT_EQ(products, brute_force_products(100U, 999U));
+    EXPECT_EQ(*products.rbegin(), 906609U);
+}
+
+TEST(Palindrome_products, test_count)
+{
+    const auto pairs = brute_force_pairs(100U, 999U).size();
+    const auto products = brute_force_products(100U, 999U).size();
+
+    EXPECT_EQ(count_palindromic_pairs(uint64_t{100U}, uint64_t{999U}), pairs);
+    EXPECT_EQ(count_palindromic_pairs(uint64_t{100U}, uint64_t{999U}, 3U), pairs);
+    EXPECT_EQ(count_palindromic_products(uint64_t{100U}, uint64_t{999U}), products);
+    EXPECT_EQ(count_palindromic_products(uint64_t{100U}, uint64_t{999U}, 3U), products);
+
+    EXPECT_EQ(count_palindromic_products<2U>(uint64_t{100U}, uint64_t{999U}), (brute_force_products<2U>(100U, 999U).size()));
+    EXPECT_EQ(count_palindromic_products(uint64_t{5U}, uint64_t{4U}), 0U);
+}
+
+TEST(Palindrome_products, test_top_of_type)
+{
+    // Square of 65535 is the last one fitting 32 bits, blocks of the sieve must not wrap around
+    std::vector<uint64_t> narrow;
+    for_each_palindromic_product(uint32_t{65000U}, uint32_t{65535U}, [&narrow](uint32_t product)
+                                 { narrow.push_back(product); });
+    std::vector<uint64_t> wide;
+    for_each_palindromic_product(uint64_t{65000U}, uint64_t{65535U}, [&wide](uint64_t product)
+                                 { wide.push_back(product); });
+
+    ASSERT_FALSE(wide.empty());
+    EXPECT_EQ(narrow, wide);
+    EXPECT_EQ(count_palindromic_products(uint32_t{65000U}, uint32_t{65535U}, 3U), wide.size());
+    EXPECT_EQ(count_palindromic_pairs(uint32_t{65500U}, uint32_t{65535U}), count_palindromic_pairs(uint64_t{65500U}, uint64_t{65535U}));
+
+    EXPECT_THROW(count_palindromic_products(uint32_t{1U}, uint32_t{65536U}), std::out_of_range);
+    EXPECT_THROW(count_palindromic_pairs(uint32_t{1U}, uint32_t{65536U}, 2U), std::out_of_range);
+}
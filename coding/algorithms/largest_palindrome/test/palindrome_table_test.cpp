@@ -0,0 +1,42 @@
+#include <palindrome_table.hpp>
+
+#include <gtest/gtest.h>
+
+TEST(Palindrome_table, test_mirror)
+{
+    static_assert(detail::mirror(123U, 3U, false) == 123321U);
+    static_assert(detail::mirror(123U, 3U, true) == 12321U);
+    static_assert(detail::mirror(990U, 3U, false) == 990099U);
+    static_assert(detail::mirror(7U, 1U, true) == 7U);
+}
+
+TEST(Palindrome_table, test_table)
+{
+    static_assert(PALINDROME_TABLE[1] == Palindrome_product{9U, 9U, 1U});
+    static_assert(PALINDROME_TABLE[2] == Palindrome_product{9009U, 99U, 91U});
+    static_assert(PALINDROME_TABLE[3] == Palindrome_product{906609U, 993U, 913U});
+
+    EXPECT_EQ(PALINDROME_TABLE[4], (Palindrome_product{99000099U, 9999U, 9901U}));
+    EXPECT_EQ(PALINDROME_TABLE[5], (Palindrome_product{9966006699U, 99979U, 99681U}));
+    EXPECT_EQ(PALINDROME_TABLE[6], (Palindrome_product{999000000999U, 999999U, 999001U}));
+    EXPECT_EQ(PALINDROME_TABLE[7], (Palindrome_product{99956644665999U, 9998017U, 9997647U}));
+}
+
+TEST(Palindrome_table, test_largest_palindrome_product)
+{
+    for (unsigned digits = 1U; digits <= PALINDROME_TABLE_DIGITS; ++digits)
+    {
+        EXPECT_EQ(largest_palindrome_product(digits), mirrored_half(digits));
+    }
+
+    // Beyond the table, computed at runtime
+    EXPECT_EQ(largest_palindrome_product(8U), (Palindrome_product{9999000000009999U, 99999999U, 99990001U}));
+}
+
+TEST(Palindrome_table, test_digits_out_of_range)
+{
+    EXPECT_THROW(mirrored_half(0U), std::out_of_range);
+    EXPECT_THROW(mirrored_half(MAX_PALINDROME_DIGITS + 1U), std::out_of_range);
+    EXPECT_THROW(largest_palindrome_product(0U), std::out_of_range);
+    EXPECT_THROW(largest_palindrome_product(MAX_PALINDROME_DIGITS + 1U), std::out_of_range);
+}
@@ -0,0 +1,142 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Common
+{
+    // Unsigned integer of any size, as little endian array of 64-bit limbs.
+    // Only what path counting needs: adding, multiplying and dividing by small numbers.
+    class Big_number
+    {
+    public:
+        __extension__ typedef unsigned __int128 Double_limb;
+
+        Big_number() = default;
+
+        Big_number(uint64_t value)
+        {
+            if (value != 0U)
+            {
+                m_limbs.push_back(value);
+            }
+        }
+
+        Big_number &operator+=(const Big_number &other)
+        {
+            if (m_limbs.size() < other.m_limbs.size())
+            {
+                m_limbs.resize(other.m_limbs.size(), 0U);
+            }
+
+            uint64_t carry{0U};
+            size_t i = 0U;
+            for (; i < other.m_limbs.size(); ++i)
+            {
+                const Double_limb sum = static_cast<Double_limb>(m_limbs[i]) + other.m_limbs[i] + carry;
+                m_limbs[i] = static_cast<uint64_t>(sum);
+                carry = static_cast<uint64_t>(sum >> 64);
+            }
+            for (; carry != 0U && i < m_limbs.size(); ++i)
+            {
+                carry = (++m_limbs[i] == 0U) ? 1U : 0U;
+            }
+            if (carry != 0U)
+            {
+                m_limbs.push_back(carry);
+            }
+
+            return *this;
+        }
+
+        Big_number &operator*=(uint64_t factor)
+        {
+            if (factor == 0U)
+            {
+                m_limbs.clear();
+                return *this;
+            }
+
+            uint64_t carry{0U};
+            for (auto &limb : m_limbs)
+            {
+                const Double_limb product = static_cast<Double_limb>(limb) * factor + carry;
+                limb = static_cast<uint64_t>(product);
+                carry = static_cast<uint64_t>(product >> 64);
+            }
+            if (carry != 0U)
+            {
+                m_limbs.push_back(carry);
+            }
+
+            return *this;
+        }
+
+        // Returns remainder
+        uint64_t divide(uint64_t divisor)
+        {
+            Double_limb remainder{0U};
+            for (auto it = m_limbs.rbegin(); it != m_limbs.rend(); ++it)
+            {
+                const Double_limb dividend = (remainder << 64) | *it;
+                *it = static_cast<uint64_t>(dividend / divisor);
+                remainder = dividend % divisor;
+            }
+            trim();
+
+            return static_cast<uint64_t>(remainder);
+        }
+
+        Big_number &operator/=(uint64_t divisor)
+        {
+            divide(divisor);
+            return *this;
+        }
+
+        bool is_zero() const noexcept { return m_limbs.empty(); }
+
+        const std::vector<uint64_t> &limbs() const noexcept { return m_limbs; }
+
+        std::string to_string() const
+        {
+            if (is_zero())
+            {
+                return "0";
+            }
+
+            // 19 decimal digits at once
+            constexpr uint64_t chunk = 10000000000000000000U;
+
+            std::string digits;
+            Big_number number = *this;
+            while (!number.is_zero())
+            {
+                uint64_t remainder = number.divide(chunk);
+                for (unsigned i = 0U; i < 19U && (remainder != 0U || !number.is_zero()); ++i)
+                {
+                    digits.push_back(static_cast<char>('0' + remainder % 10U));
+                    remainder /= 10U;
+                }
+            }
+            std::reverse(digits.begin(), digits.end());
+
+            return digits;
+        }
+
+        friend bool operator==(const Big_number &, const Big_number &) = default;
+
+    private:
+        void trim()
+        {
+            while (!m_limbs.empty() && m_limbs.back() == 0U)
+            {
+                m_limbs.pop_back();
+            }
+        }
+
+        std::vector<uint64_t> m_limbs;
+    };
+}
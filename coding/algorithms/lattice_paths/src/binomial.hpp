@@ -0,0 +1,162 @@
+#pragma once
+
+#include "big_number.hpp"
+
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+// Binomial coefficients (n, k), grid of width x height cells has (width + height, height) paths
+
+namespace Math
+{
+    // Sieve of Eratosthenes
+    inline std::vector<uint32_t> sieve_primes(uint32_t max)
+    {
+        std::vector<uint32_t> primes;
+        std::vector<bool> composite(static_cast<size_t>(max) + 1U, false);
+        for (uint64_t number = 2U; number <= max; ++number)
+        {
+            if (!composite[number])
+            {
+                primes.push_back(static_cast<uint32_t>(number));
+                for (uint64_t multiple = number * number; multiple <= max; multiple += number)
+                {
+                    composite[multiple] = true;
+                }
+            }
+        }
+        return primes;
+    }
+
+    // Exact, from prime factorization: exponent of prime p in n! is sum of n / p^i (Legendre's formula),
+    // so in (n, k) it is that of n! minus those of k! and (n - k)!. Primes are sieved once up to max_n.
+    class Binomial
+    {
+    public:
+        explicit Binomial(uint32_t max_n) : m_max_n{max_n}, m_primes{sieve_primes(max_n)} {}
+
+        Common::Big_number operator()(uint32_t n, uint32_t k) const
+        {
+            if (n > m_max_n)
+            {
+                throw std::out_of_range("Binomial: n above the sieved range");
+            }
+            if (k > n)
+            {
+                return Common::Big_number{};
+            }
+
+            // Prime powers packed into a word first, big number multiplied once per word
+            Common::Big_number result{1U};
+            uint64_t word{1U};
+            for (const auto prime : m_primes)
+            {
+                if (prime > n)
+                {
+                    break;
+                }
+
+                for (auto exponent = legendre_exponent(n, k, prime); exponent > 0U; --exponent)
+                {
+                    if (word > std::numeric_limits<uint64_t>::max() / prime)
+                    {
+                        result *= word;
+                        word = 1U;
+                    }
+                    word *= prime;
+                }
+            }
+            result *= word;
+
+            return result;
+        }
+
+        uint32_t max_n() const noexcept { return m_max_n; }
+
+    private:
+        static unsigned legendre_exponent(uint64_t n, uint64_t k, uint64_t prime) noexcept
+        {
+            unsigned exponent{0U};
+            for (uint64_t power = prime; power <= n; power *= prime)
+            {
+                exponent += static_cast<unsigned>(n / power - k / power - (n - k) / power);
+            }
+            return exponent;
+        }
+
+        uint32_t m_max_n;
+        std::vector<uint32_t> m_primes;
+    };
+
+    // Modulo prime, O(1) per query: n! / (k! (n - k)!) from tables of factorials and their inverses up to max_n
+    class Binomial_mod
+    {
+    public:
+        static constexpr uint32_t DEFAULT_MODULUS = 1000000007U;
+
+        // Modulus has to be a prime above max_n, otherwise factorials aren't invertible
+        explicit Binomial_mod(uint32_t max_n, uint32_t modulus = DEFAULT_MODULUS)
+            : m_modulus{modulus}, m_factorials(static_cast<size_t>(max_n) + 1U), m_inverse_factorials(static_cast<size_t>(max_n) + 1U)
+        {
+            if (max_n >= modulus)
+            {
+                throw std::invalid_argument("Binomial_mod: modulus has to be above max_n");
+            }
+
+            m_factorials[0] = 1U;
+            for (uint64_t i = 1U; i <= max_n; ++i)
+            {
+                m_factorials[i] = static_cast<uint32_t>(m_factorials[i - 1U] * i % m_modulus);
+            }
+
+            // Inverse by Fermat's little theorem once, the rest from (i - 1)!^-1 = i!^-1 * i
+            m_inverse_factorials[max_n] = power(m_factorials[max_n], m_modulus - 2U);
+            for (uint64_t i = max_n; i > 0U; --i)
+            {
+                m_inverse_factorials[i - 1U] = static_cast<uint32_t>(m_inverse_factorials[i] * i % m_modulus);
+            }
+        }
+
+        uint32_t operator()(uint32_t n, uint32_t k) const
+        {
+            if (n >= m_factorials.size())
+            {
+                throw std::out_of_range("Binomial_mod: n above the tables");
+            }
+            if (k > n)
+            {
+                return 0U;
+            }
+
+            const uint64_t numerator = m_factorials[n];
+            return static_cast<uint32_t>(numerator * m_inverse_factorials[k] % m_modulus * m_inverse_factorials[n - k] % m_modulus);
+        }
+
+        uint32_t modulus() const noexcept { return static_cast<uint32_t>(m_modulus); }
+
+        uint32_t max_n() const noexcept { return static_cast<uint32_t>(m_factorials.size() - 1U); }
+
+    private:
+        uint64_t power(uint64_t base, uint64_t exponent) const noexcept
+        {
+            uint64_t result{1U};
+            base %= m_modulus;
+            while (exponent > 0U)
+            {
+                if (exponent & 1U)
+                {
+                    result = result * base % m_modulus;
+                }
+                base = base * base % m_modulus;
+                exponent >>= 1U;
+            }
+            return result;
+        }
+
+        uint64_t m_modulus;
+        std::vector<uint32_t> m_factorials;
+        std::vector<uint32_t> m_inverse_factorials;
+    };
+}
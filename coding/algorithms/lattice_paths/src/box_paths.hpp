@@ -0,0 +1,127 @@
+#pragma once
+
+#include "big_number.hpp"
+#include "row_sweep.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+namespace Better
+{
+    // Box of k dimensions given in cells, each step moves by one along a single dimension.
+    // Node has as many paths as its neighbours one step back in every dimension. Only one plane
+    // of the box (all dimensions but the longest one) is kept and updated in place layer by layer:
+    // each line along the first dimension first adds the lines preceding it in the other dimensions
+    // (already updated in this layer), then it is a running sum like the 2D row.
+    template <typename Count>
+    void calculate_box_paths(std::span<const unsigned> cells, Count &paths)
+    {
+        if (cells.size() < 2U)
+        {
+            paths = Count{1U};
+            return;
+        }
+
+        // Longest dimension is rolled, second longest is the line
+        std::vector<size_t> nodes(cells.begin(), cells.end());
+        std::sort(nodes.begin(), nodes.end(), std::greater<>{});
+        std::rotate(nodes.begin(), nodes.begin() + 1, nodes.end());
+        for (auto &node : nodes)
+        {
+            ++node;
+        }
+
+        const size_t plane_dims = nodes.size() - 1U;
+        std::vector<size_t> strides(plane_dims, 1U);
+        for (size_t dim = 1U; dim < plane_dims; ++dim)
+        {
+            strides[dim] = strides[dim - 1U] * nodes[dim - 1U];
+        }
+        const size_t line_size = nodes[0];
+        const size_t plane_size = strides.back() * nodes[plane_dims - 1U];
+
+        std::vector<Count> plane(plane_size, Count{0U});
+        plane[0] = Count{1U};
+
+        std::vector<size_t> coordinates(plane_dims, 0U);
+        for (size_t layer = 0U; layer < nodes.back(); ++layer)
+        {
+            std::fill(coordinates.begin(), coordinates.end(), 0U);
+            for (size_t line_start = 0U; line_start < plane_size; line_start += line_size)
+            {
+                Count *line = plane.data() + line_start;
+                for (size_t dim = 1U; dim < plane_dims; ++dim)
+                {
+                    if (coordinates[dim] != 0U)
+                    {
+                        const Count *previous = line - strides[dim];
+                        for (size_t x = 0U; x < line_size; ++x)
+                        {
+                            line[x] += previous[x];
+                        }
+                    }
+                }
+
+                if constexpr (std::is_unsigned_v<Count> && (sizeof(Count) == 4U || sizeof(Count) == 8U))
+                {
+                    sweep_row(line, line_size);
+                }
+                else
+                {
+                    for (size_t x = 1U; x < line_size; ++x)
+                    {
+                        line[x] += line[x - 1U];
+                    }
+                }
+
+                // Next line: odometer over the dimensions above the first one
+                for (size_t dim = 1U; dim < plane_dims && ++coordinates[dim] == nodes[dim]; ++dim)
+                {
+                    coordinates[dim] = 0U;
+                }
+            }
+        }
+
+        paths = plane.back();
+    }
+}
+
+namespace Math
+{
+    // Multinomial coefficient (c0 + c1 + ...)! / (c0! c1! ...) as a product of binomial coefficients
+    // (c0 + ... + ci, ci), built step by step like the 2D one
+    inline void calculate_box_paths(std::span<const unsigned> cells, double &paths)
+    {
+        paths = 1;
+        uint64_t total = cells.empty() ? 0U : cells[0];
+        for (size_t dim = 1U; dim < cells.size(); ++dim)
+        {
+            for (uint64_t k = 1U; k <= cells[dim]; ++k)
+            {
+                paths *= static_cast<double>(total + k) / static_cast<double>(k);
+            }
+            total += cells[dim];
+        }
+    }
+
+    // Exact, each step divides without remainder
+    inline void calculate_box_paths(std::span<const unsigned> cells, Common::Big_number &paths)
+    {
+        paths = 1U;
+        uint64_t total = cells.empty() ? 0U : cells[0];
+        for (size_t dim = 1U; dim < cells.size(); ++dim)
+        {
+            for (uint64_t k = 1U; k <= cells[dim]; ++k)
+            {
+                paths *= total + k;
+                paths /= k;
+            }
+            total += cells[dim];
+        }
+    }
+}
@@ -0,0 +1,246 @@
+#pragma once
+
+#include <algorithm>
+#include <barrier>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace Common
+{
+    // Directed acyclic graph in compressed sparse row layout: edges of node i are
+    // m_targets[m_offsets[i] .. m_offsets[i + 1]), same for edges reversed.
+    // Nodes are sorted topologically and grouped in levels: level of a node is the longest path
+    // leading to it, so edges always go to a higher level and nodes of a level are independent.
+    class Dag
+    {
+    public:
+        using Edge = std::pair<unsigned, unsigned>;
+
+        Dag(unsigned nodes, const std::vector<Edge> &edges)
+        {
+            // Empty graph: offsets hold the single end, no levels
+            if (nodes == 0U)
+            {
+                if (!edges.empty())
+                {
+                    throw std::out_of_range("Dag: edge to a node out of range");
+                }
+                m_offsets.assign(1U, 0U);
+                m_reverse_offsets.assign(1U, 0U);
+                m_level_offsets.assign(1U, 0U);
+                return;
+            }
+            build_csr(nodes, edges, false, m_offsets, m_targets);
+            build_csr(nodes, edges, true, m_reverse_offsets, m_sources);
+            sort_topologically(nodes);
+        }
+
+        unsigned size() const noexcept { return static_cast<unsigned>(m_offsets.size() - 1U); }
+
+        size_t edges_count() const noexcept { return m_targets.size(); }
+
+        std::span<const unsigned> successors(unsigned node) const noexcept
+        {
+            return {m_targets.data() + m_offsets[node], m_targets.data() + m_offsets[node + 1U]};
+        }
+
+        std::span<const unsigned> predecessors(unsigned node) const noexcept
+        {
+            return {m_sources.data() + m_reverse_offsets[node], m_sources.data() + m_reverse_offsets[node + 1U]};
+        }
+
+        const std::vector<unsigned> &topological_order() const noexcept { return m_order; }
+
+        size_t levels() const noexcept { return m_level_offsets.size() - 1U; }
+
+        std::span<const unsigned> level(size_t level) const noexcept
+        {
+            return {m_order.data() + m_level_offsets[level], m_order.data() + m_level_offsets[level + 1U]};
+        }
+
+    private:
+        // Counting sort of edges by source (or by target when reversed)
+        static void build_csr(unsigned nodes, const std::vector<Edge> &edges, bool reversed, std::vector<size_t> &offsets, std::vector<unsigned> &targets)
+        {
+            offsets.assign(static_cast<size_t>(nodes) + 1U, 0U);
+            for (const auto &[from, to] : edges)
+            {
+                if (from >= nodes || to >= nodes)
+                {
+                    throw std::out_of_range("Dag: edge to a node out of range");
+                }
+                ++offsets[(reversed ? to : from) + 1U];
+            }
+            for (size_t node = 0U; node < nodes; ++node)
+            {
+                offsets[node + 1U] += offsets[node];
+            }
+
+            targets.resize(edges.size());
+            std::vector<size_t> next(offsets.begin(), offsets.end() - 1);
+            for (const auto &[from, to] : edges)
+            {
+                targets[next[reversed ? to : from]++] = reversed ? from : to;
+            }
+        }
+
+        // Kahn's algorithm in rounds: nodes left without incoming edges in a round make the next level
+        void sort_topologically(unsigned nodes)
+        {
+            std::vector<size_t> in_degrees(nodes);
+            for (unsigned node = 0U; node < nodes; ++node)
+            {
+                in_degrees[node] = m_reverse_offsets[node + 1U] - m_reverse_offsets[node];
+                if (in_degrees[node] == 0U)
+                {
+                    m_order.push_back(node);
+                }
+            }
+            m_order.reserve(nodes);
+            m_level_offsets.push_back(0U);
+
+            size_t level_begin = 0U;
+            while (level_begin < m_order.size())
+            {
+                const size_t level_end = m_order.size();
+                m_level_offsets.push_back(level_end);
+                for (size_t i = level_begin; i < level_end; ++i)
+                {
+                    for (const auto successor : successors(m_order[i]))
+                    {
+                        if (--in_degrees[successor] == 0U)
+                        {
+                            m_order.push_back(successor);
+                        }
+                    }
+                }
+                level_begin = level_end;
+            }
+
+            if (m_order.size() != nodes)
+            {
+                throw std::invalid_argument("Dag: graph has a cycle");
+            }
+        }
+
+        std::vector<size_t> m_offsets;
+        std::vector<unsigned> m_targets;
+        std::vector<size_t> m_reverse_offsets;
+        std::vector<unsigned> m_sources;
+        std::vector<unsigned> m_order;
+        std::vector<size_t> m_level_offsets;
+    };
+
+    // Grid of width x height nodes as a graph, edges to the right and down neighbours
+    inline Dag build_dag(unsigned width, unsigned height)
+    {
+        std::vector<Dag::Edge> edges;
+        edges.reserve(2U * static_cast<size_t>(width) * height);
+        for (unsigned y = 0U; y < height; ++y)
+        {
+            for (unsigned x = 0U; x < width; ++x)
+            {
+                const unsigned node = x + y * width;
+                if (x + 1U < width)
+                {
+                    edges.emplace_back(node, node + 1U);
+                }
+                if (y + 1U < height)
+                {
+                    edges.emplace_back(node, node + width);
+                }
+            }
+        }
+        return Dag{width * height, edges};
+    }
+}
+
+namespace Better
+{
+    namespace detail
+    {
+        inline void check_nodes(const Common::Dag &dag, unsigned source, unsigned target)
+        {
+            if (source >= dag.size() || target >= dag.size())
+            {
+                throw std::out_of_range("Dag: source or target out of range");
+            }
+        }
+    }
+
+    // Same idea as for grids: nodes taken in topological order, each one passes its paths to its successors
+    template <typename Count>
+    void calculate_paths(const Common::Dag &dag, unsigned source, unsigned target, Count &paths)
+    {
+        detail::check_nodes(dag, source, target);
+        std::vector<Count> node_paths(dag.size(), Count{0U});
+        node_paths[source] = Count{1U};
+
+        for (const auto node : dag.topological_order())
+        {
+            if (node == target)
+            {
+                break;
+            }
+            for (const auto successor : dag.successors(node))
+            {
+                node_paths[successor] += node_paths[node];
+            }
+        }
+
+        paths = node_paths[target];
+    }
+
+    // Level by level, nodes of a level split among threads; each node sums paths of its predecessors
+    // (from lower levels), so threads write only their own nodes. threads = 0 means all hardware threads.
+    template <typename Count>
+    void calculate_paths_levels(const Common::Dag &dag, unsigned source, unsigned target, Count &paths, unsigned threads = 0U)
+    {
+        detail::check_nodes(dag, source, target);
+        if (threads == 0U)
+        {
+            threads = std::max(std::thread::hardware_concurrency(), 1U);
+        }
+
+        std::vector<Count> node_paths(dag.size(), Count{0U});
+
+        std::barrier level_done{static_cast<std::ptrdiff_t>(threads)};
+        auto worker = [&](unsigned thread)
+        {
+            for (size_t level = 0U; level < dag.levels(); ++level)
+            {
+                const auto nodes = dag.level(level);
+                const size_t chunk = (nodes.size() + threads - 1U) / threads;
+                const size_t begin = std::min(nodes.size(), thread * chunk);
+                const size_t end = std::min(nodes.size(), begin + chunk);
+
+                for (size_t i = begin; i < end; ++i)
+                {
+                    const auto node = nodes[i];
+                    Count count{node == source ? 1U : 0U};
+                    for (const auto predecessor : dag.predecessors(node))
+                    {
+                        count += node_paths[predecessor];
+                    }
+                    node_paths[node] = count;
+                }
+                level_done.arrive_and_wait();
+            }
+        };
+
+        std::vector<std::jthread> workers;
+        for (unsigned thread = 1U; thread < threads; ++thread)
+        {
+            workers.emplace_back(worker, thread);
+        }
+        worker(0U);
+        workers.clear();
+
+        paths = node_paths[target];
+    }
+}
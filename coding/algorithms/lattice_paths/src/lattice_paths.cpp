@@ -1,199 +1,541 @@
 // Copyright (c) 2023, Piotr Staniszewski
 
+#include "binomial.hpp"
+#include "box_paths.hpp"
+#include "dag_paths.hpp"
+#include "lattice_paths.hpp"
+#include "obstacle_paths.hpp"
+#include "path_cache.hpp"
+#include "path_table.hpp"
+#include "row_sweep.hpp"
+
 #include <benchmark/benchmark.h>
 
+#include <algorithm>
 #include <iostream>
-#include <array>
-#include <optional>
-#include <cstdint>
+#include <random>
+#include <utility>
+#include <vector>
 
-namespace Common
+static void benchmark_calculate_paths_brute(benchmark::State &state)
 {
+    for (auto _ : state)
+    {
+        unsigned long paths{0UL};
+
+        auto nodes = Common::build_nodes<13U, 13U>();
+        Brute::calculate_paths(nodes[0], nodes, paths);
+        benchmark::DoNotOptimize(paths);
 
-    template <unsigned WIDTH, unsigned HEIGHT>
-    struct Node
+        //std::cout << "paths: " << paths << "\n";
+    }
+}
+BENCHMARK(benchmark_calculate_paths_brute);
+
+static void benchmark_calculate_paths_memoized(benchmark::State &state)
+{
+    for (auto _ : state)
     {
-        Node() = default;
+        unsigned long paths{0UL};
 
-        Node(unsigned x, unsigned y) : m_x{x}, m_y{y}, m_paths(0U)
-        {
-            // auto idx = calculate_idx(m_x, m_y);
-            // std::cout << "at(" << idx << ") = Node(" << x << "," << y << ")\n";
-            if (x + 1U < WIDTH)
-            {
-                m_left_neighbour_idx = calculate_idx(x + 1U, y);
-                // std::cout << "has neighbout left with idx = " << m_left_neighbour_idx.value() << "\n";
-            }
-            if (y + 1U < HEIGHT)
-            {
-                m_down_neighbour_idx = calculate_idx(x, y + 1U);
-                // std::cout << "has neighbout down with idx = " << m_down_neighbour_idx.value() << "\n";
-            }
-        }
+        auto nodes = Common::build_nodes<13U, 13U>();
+        Memoized::calculate_paths(nodes[0], nodes, paths);
+        benchmark::DoNotOptimize(paths);
+    }
+}
+BENCHMARK(benchmark_calculate_paths_memoized);
 
-        static unsigned long calculate_idx(unsigned x, unsigned y) noexcept { return x + y * WIDTH; }
+static void benchmark_calculate_paths_better(benchmark::State &state)
+{
+    for (auto _ : state)
+    {
+        unsigned long paths{0UL};
+
+        auto nodes = Common::build_nodes<13U, 13U>();
+        Better::calculate_paths(nodes, paths);
+        benchmark::DoNotOptimize(paths);
+
+        //std::cout << "paths: " << paths << "\n";
+    }
+}
+BENCHMARK(benchmark_calculate_paths_better);
+
+static void benchmark_calculate_paths_central_binomial_coefficient(benchmark::State &state)
+{
+    for (auto _ : state)
+    {
+        double paths{0};
+
+        Math::calculate_paths<12U, 12U>(paths);
+        benchmark::DoNotOptimize(paths);
+
+        //std::cout << "(math) paths: " << static_cast<size_t>(paths) << "\n";
+    }
+}
+BENCHMARK(benchmark_calculate_paths_central_binomial_coefficient);
 
-        unsigned m_x{0U};
-        unsigned m_y{0U};
-        unsigned long m_paths{0U};
-        std::optional<unsigned> m_left_neighbour_idx;
-        std::optional<unsigned> m_down_neighbour_idx;
-    };
+// Grids with size known at runtime, argument is width and height in cells (nodes are one more);
+// unsigned long overflows above 33x33 cells, results wrap but the work done is the same.
+// Node takes 32 bytes, so the node based grids stop at 4096x4096 (512 MiB).
 
-    template <unsigned WIDTH, unsigned HEIGHT>
-    auto build_nodes() -> std::array<Node<WIDTH, HEIGHT>, WIDTH * HEIGHT>
+static void benchmark_calculate_paths_brute_runtime(benchmark::State &state)
+{
+    const auto size = static_cast<unsigned>(state.range(0));
+    for (auto _ : state)
     {
-        std::array<Node<WIDTH, HEIGHT>, WIDTH * HEIGHT> grid{};
-        for (unsigned i = 0U; i < WIDTH; ++i)
+        unsigned long paths{0UL};
+
+        auto nodes = Common::build_nodes(size + 1U, size + 1U);
+        Brute::calculate_paths(nodes[0], nodes, paths);
+        benchmark::DoNotOptimize(paths);
+    }
+}
+BENCHMARK(benchmark_calculate_paths_brute_runtime)->DenseRange(4, 12, 2);
+
+static void benchmark_calculate_paths_better_runtime(benchmark::State &state)
+{
+    const auto size = static_cast<unsigned>(state.range(0));
+    for (auto _ : state)
+    {
+        unsigned long paths{0UL};
+
+        auto nodes = Common::build_nodes(size + 1U, size + 1U);
+        Better::calculate_paths(nodes, paths);
+        benchmark::DoNotOptimize(paths);
+    }
+    state.SetComplexityN(state.range(0) * state.range(0));
+    state.SetItemsProcessed(state.iterations() * (state.range(0) + 1) * (state.range(0) + 1));
+}
+BENCHMARK(benchmark_calculate_paths_better_runtime)->RangeMultiplier(2)->Range(8, 4096)->Complexity(benchmark::oN);
+
+static void benchmark_calculate_paths_memoized_runtime(benchmark::State &state)
+{
+    const auto size = static_cast<unsigned>(state.range(0));
+    for (auto _ : state)
+    {
+        unsigned long paths{0UL};
+
+        auto nodes = Common::build_nodes(size + 1U, size + 1U);
+        Memoized::calculate_paths(nodes[0], nodes, paths);
+        benchmark::DoNotOptimize(paths);
+    }
+    state.SetComplexityN(state.range(0) * state.range(0));
+    state.SetItemsProcessed(state.iterations() * (state.range(0) + 1) * (state.range(0) + 1));
+}
+BENCHMARK(benchmark_calculate_paths_memoized_runtime)->RangeMultiplier(2)->Range(8, 4096)->Complexity(benchmark::oN);
+
+// Path counts only, single row
+static void benchmark_calculate_paths_better_row(benchmark::State &state)
+{
+    const auto size = static_cast<unsigned>(state.range(0));
+    for (auto _ : state)
+    {
+        unsigned long paths{0UL};
+
+        Better::calculate_paths(size, size, paths);
+        benchmark::DoNotOptimize(paths);
+    }
+    state.SetComplexityN(state.range(0) * state.range(0));
+    state.SetItemsProcessed(state.iterations() * state.range(0) * state.range(0));
+}
+BENCHMARK(benchmark_calculate_paths_better_row)->RangeMultiplier(2)->Range(8, 8 << 10)->Arg(10000)->Complexity(benchmark::oN);
+
+// Kernels of the row sweep alone, argument is row length; counts wrap, the work is the same
+template <typename Count, void (*SWEEP_ROW)(Count *, size_t) noexcept>
+static void benchmark_sweep_row(benchmark::State &state)
+{
+    std::vector<Count> row(static_cast<size_t>(state.range(0)), Count{1U});
+    for (auto _ : state)
+    {
+        SWEEP_ROW(row.data(), row.size());
+        benchmark::DoNotOptimize(row.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_TEMPLATE(benchmark_sweep_row, uint32_t, Better::detail::sweep_row_scalar<uint32_t>)->Range(64, 64 << 10);
+BENCHMARK_TEMPLATE(benchmark_sweep_row, uint64_t, Better::detail::sweep_row_scalar<uint64_t>)->Range(64, 64 << 10);
+#ifdef LATTICE_PATHS_X86
+BENCHMARK_TEMPLATE(benchmark_sweep_row, uint32_t, Better::detail::sweep_row_avx2)->Range(64, 64 << 10);
+BENCHMARK_TEMPLATE(benchmark_sweep_row, uint64_t, Better::detail::sweep_row_avx2)->Range(64, 64 << 10);
+#endif
+
+static void benchmark_calculate_paths_central_binomial_coefficient_runtime(benchmark::State &state)
+{
+    const auto size = static_cast<unsigned>(state.range(0));
+    for (auto _ : state)
+    {
+        double paths{0};
+
+        Math::calculate_paths(size, size, paths);
+        benchmark::DoNotOptimize(paths);
+    }
+    state.SetComplexityN(state.range(0));
+}
+BENCHMARK(benchmark_calculate_paths_central_binomial_coefficient_runtime)->RangeMultiplier(2)->Range(8, 8 << 10)->Arg(10000)->Complexity(benchmark::oN);
+
+// Exact path counts with big numbers, to compare with the fixed width ones above
+static void benchmark_calculate_paths_better_row_big_number(benchmark::State &state)
+{
+    const auto size = static_cast<unsigned>(state.range(0));
+    for (auto _ : state)
+    {
+        Common::Big_number paths;
+
+        Better::calculate_paths(size, size, paths);
+        benchmark::DoNotOptimize(paths);
+    }
+    state.SetComplexityN(state.range(0) * state.range(0));
+    state.SetItemsProcessed(state.iterations() * state.range(0) * state.range(0));
+}
+BENCHMARK(benchmark_calculate_paths_better_row_big_number)->RangeMultiplier(2)->Range(8, 2048);
+
+static void benchmark_calculate_paths_central_binomial_coefficient_big_number(benchmark::State &state)
+{
+    const auto size = static_cast<unsigned>(state.range(0));
+    for (auto _ : state)
+    {
+        Common::Big_number paths;
+
+        Math::calculate_paths(size, size, paths);
+        benchmark::DoNotOptimize(paths);
+    }
+    state.SetComplexityN(state.range(0));
+}
+BENCHMARK(benchmark_calculate_paths_central_binomial_coefficient_big_number)->RangeMultiplier(2)->Range(8, 8 << 10)->Arg(10000);
+
+// Exact binomial from prime factorization
+static void benchmark_binomial(benchmark::State &state)
+{
+    const auto size = static_cast<uint32_t>(state.range(0));
+    const Math::Binomial binomial{2U * size};
+    for (auto _ : state)
+    {
+        Common::Big_number paths = binomial(2U * size, size);
+        benchmark::DoNotOptimize(paths);
+    }
+    state.SetComplexityN(state.range(0));
+}
+BENCHMARK(benchmark_binomial)->RangeMultiplier(2)->Range(8, 8 << 10)->Arg(10000);
+
+// Many queries of random grids up to 10000x10000, modulo prime
+static void benchmark_binomial_mod(benchmark::State &state)
+{
+    constexpr uint32_t max_size = 10000U;
+    const Math::Binomial_mod binomial{2U * max_size};
+
+    std::mt19937 generator{42U};
+    std::uniform_int_distribution<uint32_t> distribution{0U, max_size};
+    std::vector<std::pair<uint32_t, uint32_t>> grids(4096U);
+    for (auto &grid : grids)
+    {
+        grid = {distribution(generator), distribution(generator)};
+    }
+
+    for (auto _ : state)
+    {
+        for (const auto &[width, height] : grids)
         {
-            for (unsigned j = 0U; j < HEIGHT; ++j)
-            {
-                grid[Node<WIDTH, HEIGHT>::calculate_idx(i, j)] = Node<WIDTH, HEIGHT>(i, j);
-            }
+            uint32_t paths = binomial(width + height, height);
+            benchmark::DoNotOptimize(paths);
         }
+    }
+    state.SetItemsProcessed(state.iterations() * grids.size());
+}
+BENCHMARK(benchmark_binomial_mod);
 
-        return grid;
+// Batches of random grid queries, each answered from scratch or from the shared cache
+static std::vector<Math::Grid_size> random_grids(unsigned max_size, size_t count)
+{
+    std::mt19937 generator{42U};
+    std::uniform_int_distribution<unsigned> distribution{0U, max_size};
+    std::vector<Math::Grid_size> grids(count);
+    for (auto &grid : grids)
+    {
+        grid = {distribution(generator), distribution(generator)};
     }
+    return grids;
 }
 
-namespace Brute
+static void set_per_query_counters(benchmark::State &state, size_t queries)
 {
-    using Common::Node;
+    state.SetItemsProcessed(state.iterations() * queries);
+    state.counters["per_query"] = benchmark::Counter(static_cast<double>(queries), benchmark::Counter::kIsIterationInvariantRate | benchmark::Counter::kInvert);
+}
 
-    // Recursive, all possibilities
-    template <unsigned WIDTH, unsigned HEIGHT>
-    void calculate_paths(const Node<WIDTH, HEIGHT> &node, const std::array<Node<WIDTH, HEIGHT>, WIDTH * HEIGHT> &nodes, unsigned long &paths)
+static void benchmark_queries_from_scratch(benchmark::State &state)
+{
+    const auto grids = random_grids(33U, 4096U);
+    for (auto _ : state)
     {
-        if (node.m_left_neighbour_idx.has_value())
+        for (const auto &grid : grids)
         {
-            calculate_paths(nodes[node.m_left_neighbour_idx.value()], nodes, paths);
+            unsigned long paths{0UL};
+            Better::calculate_paths(grid.m_width, grid.m_height, paths);
+            benchmark::DoNotOptimize(paths);
         }
+    }
+    set_per_query_counters(state, grids.size());
+}
+BENCHMARK(benchmark_queries_from_scratch);
+
+static void benchmark_queries_path_cache(benchmark::State &state)
+{
+    const auto grids = random_grids(33U, 4096U);
+    Math::Path_cache cache;
+    std::vector<unsigned long> results;
+    for (auto _ : state)
+    {
+        cache.paths(grids, results);
+        benchmark::DoNotOptimize(results.data());
+    }
+    set_per_query_counters(state, grids.size());
+}
+BENCHMARK(benchmark_queries_path_cache);
 
-        if (node.m_down_neighbour_idx.has_value())
+static void benchmark_queries_mod_from_scratch(benchmark::State &state)
+{
+    const auto grids = random_grids(10000U, 4096U);
+    for (auto _ : state)
+    {
+        for (const auto &grid : grids)
         {
-            calculate_paths(nodes[node.m_down_neighbour_idx.value()], nodes, paths);
+            const Math::Binomial_mod binomial{grid.m_width + grid.m_height};
+            uint32_t paths = binomial(grid.m_width + grid.m_height, grid.m_height);
+            benchmark::DoNotOptimize(paths);
         }
+    }
+    set_per_query_counters(state, grids.size());
+}
+BENCHMARK(benchmark_queries_mod_from_scratch);
+
+static void benchmark_queries_mod_path_cache(benchmark::State &state)
+{
+    const auto grids = random_grids(10000U, 4096U);
+    Math::Path_cache cache;
+    std::vector<uint32_t> results;
+    for (auto _ : state)
+    {
+        cache.paths_mod(grids, results);
+        benchmark::DoNotOptimize(results.data());
+    }
+    set_per_query_counters(state, grids.size());
+}
+BENCHMARK(benchmark_queries_mod_path_cache);
 
-        if (!node.m_down_neighbour_idx.has_value() && !node.m_left_neighbour_idx.has_value())
+// Exact counts up to 128 bits: compile time table against computing each
+static void benchmark_queries_path_table(benchmark::State &state)
+{
+    const auto grids = random_grids(65U, 4096U);
+    for (auto _ : state)
+    {
+        for (const auto &grid : grids)
         {
-            ++paths;
+            auto paths = Math::table_paths(grid.m_width, grid.m_height);
+            benchmark::DoNotOptimize(paths);
         }
     }
+    set_per_query_counters(state, grids.size());
 }
+BENCHMARK(benchmark_queries_path_table);
 
-namespace Better
+static void benchmark_queries_128_from_scratch(benchmark::State &state)
 {
-    using Common::Node;
-
-    // Iterates once
-    template <unsigned WIDTH, unsigned HEIGHT>
-    void calculate_paths(std::array<Node<WIDTH, HEIGHT>, WIDTH * HEIGHT> &nodes, unsigned long &paths)
+    const auto grids = random_grids(65U, 4096U);
+    for (auto _ : state)
     {
-        nodes[0].m_paths = 1; // first path
+        for (const auto &grid : grids)
+        {
+            Math::uint128_t paths{0U};
+            Better::calculate_paths(grid.m_width, grid.m_height, paths);
+            benchmark::DoNotOptimize(paths);
+        }
+    }
+    set_per_query_counters(state, grids.size());
+}
+BENCHMARK(benchmark_queries_128_from_scratch);
 
-        // Each node has as many possible paths as its parents
-        for (auto &node : nodes)
+static void benchmark_queries_big_number_from_scratch(benchmark::State &state)
+{
+    const auto grids = random_grids(65U, 4096U);
+    for (auto _ : state)
+    {
+        for (const auto &grid : grids)
         {
-            // std::cout << "at(" << node.m_x << ", " << node.m_y << ") = " << node.m_weight << "\n";
-            if (node.m_left_neighbour_idx.has_value())
-            {
-                nodes[node.m_left_neighbour_idx.value()].m_paths += node.m_paths;
-            }
+            Common::Big_number paths;
+            Math::calculate_paths(grid.m_width, grid.m_height, paths);
+            benchmark::DoNotOptimize(paths);
+        }
+    }
+    set_per_query_counters(state, grids.size());
+}
+BENCHMARK(benchmark_queries_big_number_from_scratch);
 
-            if (node.m_down_neighbour_idx.has_value())
+// Grids with 10% of nodes blocked, argument is width and height in nodes
+static Common::Obstacle_map random_obstacles(unsigned size)
+{
+    std::mt19937 generator{42U};
+    std::bernoulli_distribution blocked{0.1};
+    Common::Obstacle_map obstacles{size, size};
+    for (unsigned y = 0U; y < size; ++y)
+    {
+        for (unsigned x = 0U; x < size; ++x)
+        {
+            if ((x != 0U || y != 0U) && blocked(generator))
             {
-                nodes[node.m_down_neighbour_idx.value()].m_paths += node.m_paths;
+                obstacles.block(x, y);
             }
         }
-
-        paths = nodes.back().m_paths;
     }
+    return obstacles;
+}
+
+static void benchmark_obstacles_sweep(benchmark::State &state)
+{
+    const auto obstacles = random_obstacles(static_cast<unsigned>(state.range(0)));
+    for (auto _ : state)
+    {
+        unsigned long paths{0UL};
 
+        Better::calculate_paths_sweep(obstacles, paths);
+        benchmark::DoNotOptimize(paths);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0) * state.range(0));
 }
+BENCHMARK(benchmark_obstacles_sweep)->RangeMultiplier(4)->Range(256, 4096)->Arg(10000);
 
-namespace Math
+// Second argument is number of threads
+static void benchmark_obstacles_wavefront(benchmark::State &state)
 {
-    template <size_t NUM>
-    struct power2
+    const auto obstacles = random_obstacles(static_cast<unsigned>(state.range(0)));
+    for (auto _ : state)
     {
-        static constexpr size_t m_value = NUM * NUM;
-    };
+        unsigned long paths{0UL};
+
+        Better::calculate_paths_wavefront(obstacles, paths, static_cast<unsigned>(state.range(1)));
+        benchmark::DoNotOptimize(paths);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0) * state.range(0));
+}
+BENCHMARK(benchmark_obstacles_wavefront)->ArgsProduct({{256, 1024, 4096, 10000}, {1, 2, 4}})->UseRealTime();
 
-    template <unsigned long NUM>
-    struct factorial
+// Cube of k dimensions, arguments are k and side in cells
+static void benchmark_box_better(benchmark::State &state)
+{
+    const std::vector<unsigned> cells(static_cast<size_t>(state.range(0)), static_cast<unsigned>(state.range(1)));
+    for (auto _ : state)
     {
-        static constexpr size_t m_value = NUM * factorial<NUM - 1U>::m_value;
-    };
+        unsigned long paths{0UL};
 
-    template <>
-    struct factorial<0>
+        Better::calculate_box_paths(cells, paths);
+        benchmark::DoNotOptimize(paths);
+    }
+    int64_t nodes{1};
+    for (const auto side : cells)
     {
-        static constexpr size_t m_value = 1U;
-    };
+        nodes *= side + 1;
+    }
+    state.SetItemsProcessed(state.iterations() * nodes);
+}
+BENCHMARK(benchmark_box_better)->Args({2, 1024})->Args({2, 4096})->Args({3, 64})->Args({3, 256})->Args({4, 16})->Args({4, 64});
 
-    template <unsigned WIDTH, unsigned HEIGHT>
-    void calculate_paths_factorial(unsigned long &paths)
+static void benchmark_box_better_big_number(benchmark::State &state)
+{
+    const std::vector<unsigned> cells(static_cast<size_t>(state.range(0)), static_cast<unsigned>(state.range(1)));
+    for (auto _ : state)
     {
-        constexpr unsigned long grid_width = WIDTH - 1U;
+        Common::Big_number paths;
 
-        // with central binomial coefficient; too big numbers generated, not a good way
-        paths = (factorial<2U * grid_width>::m_value) / (power2<factorial<grid_width>::m_value>::m_value);
+        Better::calculate_box_paths(cells, paths);
+        benchmark::DoNotOptimize(paths);
     }
+}
+BENCHMARK(benchmark_box_better_big_number)->Args({2, 256})->Args({3, 64})->Args({4, 16});
 
-    template <unsigned WIDTH, unsigned HEIGHT>
-    void calculate_paths(double &paths)
+static void benchmark_box_multinomial_big_number(benchmark::State &state)
+{
+    const std::vector<unsigned> cells(static_cast<size_t>(state.range(0)), static_cast<unsigned>(state.range(1)));
+    for (auto _ : state)
     {
-        constexpr unsigned long grid_width = WIDTH;
+        Common::Big_number paths;
+
+        Math::calculate_box_paths(cells, paths);
+        benchmark::DoNotOptimize(paths);
+    }
+}
+BENCHMARK(benchmark_box_multinomial_big_number)->Args({2, 256})->Args({3, 64})->Args({4, 16})->Args({2, 4096})->Args({3, 256})->Args({4, 64});
 
-        // with central binomial coefficient - other version
-        //std::cout << "grid_width = " << grid_width << "\n";
-        paths = 1;
-        for (size_t k = 1; k <= grid_width; ++k) {
-            paths *= static_cast<double>(grid_width + k)/k;
+// Random graph with edges only to later nodes, argument is number of nodes, 8 edges per node on average
+static Common::Dag random_dag(unsigned nodes)
+{
+    std::mt19937 generator{42U};
+    std::uniform_int_distribution<unsigned> distance{1U, 64U};
+    std::vector<Common::Dag::Edge> edges;
+    edges.reserve(8U * static_cast<size_t>(nodes));
+    for (unsigned node = 0U; node + 1U < nodes; ++node)
+    {
+        for (unsigned edge = 0U; edge < 8U; ++edge)
+        {
+            edges.emplace_back(node, std::min(node + distance(generator), nodes - 1U));
         }
     }
+    return Common::Dag{nodes, edges};
 }
 
-static void benchmark_calculate_paths_brute(benchmark::State &state)
+static void benchmark_dag_grid(benchmark::State &state)
 {
+    const auto size = static_cast<unsigned>(state.range(0));
+    const auto dag = Common::build_dag(size, size);
     for (auto _ : state)
     {
         unsigned long paths{0UL};
 
-        auto nodes = Common::build_nodes<13U, 13U>();
-        Brute::calculate_paths(nodes[0], nodes, paths);
-
-        //std::cout << "paths: " << paths << "\n";
+        Better::calculate_paths(dag, 0U, dag.size() - 1U, paths);
+        benchmark::DoNotOptimize(paths);
     }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(dag.edges_count()));
 }
-BENCHMARK(benchmark_calculate_paths_brute);
+BENCHMARK(benchmark_dag_grid)->RangeMultiplier(4)->Range(256, 4096);
 
-static void benchmark_calculate_paths_better(benchmark::State &state)
+static void benchmark_dag_random(benchmark::State &state)
 {
+    const auto dag = random_dag(static_cast<unsigned>(state.range(0)));
     for (auto _ : state)
     {
         unsigned long paths{0UL};
 
-        auto nodes = Common::build_nodes<13U, 13U>();
-        Better::calculate_paths(nodes, paths);
-
-        //std::cout << "paths: " << paths << "\n";
+        Better::calculate_paths(dag, 0U, dag.size() - 1U, paths);
+        benchmark::DoNotOptimize(paths);
     }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(dag.edges_count()));
 }
-BENCHMARK(benchmark_calculate_paths_better);
+BENCHMARK(benchmark_dag_random)->RangeMultiplier(8)->Range(1 << 14, 1 << 20);
 
-static void benchmark_calculate_paths_central_binomial_coefficient(benchmark::State &state)
+// Grid levels are its anti-diagonals, wide enough to split, second argument is number of threads
+static void benchmark_dag_grid_levels(benchmark::State &state)
 {
+    const auto size = static_cast<unsigned>(state.range(0));
+    const auto dag = Common::build_dag(size, size);
     for (auto _ : state)
     {
-        double paths{0};
+        unsigned long paths{0UL};
 
-        Math::calculate_paths<12U, 12U>(paths);
+        Better::calculate_paths_levels(dag, 0U, dag.size() - 1U, paths, static_cast<unsigned>(state.range(1)));
+        benchmark::DoNotOptimize(paths);
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(dag.edges_count()));
+}
+BENCHMARK(benchmark_dag_grid_levels)->ArgsProduct({{256, 1024, 4096}, {1, 2, 4}})->UseRealTime();
 
-        //std::cout << "(math) paths: " << static_cast<size_t>(paths) << "\n";
+static void benchmark_dag_build(benchmark::State &state)
+{
+    for (auto _ : state)
+    {
+        const auto dag = random_dag(static_cast<unsigned>(state.range(0)));
+        benchmark::DoNotOptimize(dag.levels());
     }
 }
-BENCHMARK(benchmark_calculate_paths_central_binomial_coefficient);
+BENCHMARK(benchmark_dag_build)->RangeMultiplier(8)->Range(1 << 14, 1 << 20);
 
 BENCHMARK_MAIN();
 
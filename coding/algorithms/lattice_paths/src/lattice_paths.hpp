@@ -0,0 +1,318 @@
+#pragma once
+
+#include "big_number.hpp"
+#include "row_sweep.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace Common
+{
+
+    template <unsigned WIDTH, unsigned HEIGHT>
+    struct Node
+    {
+        Node() = default;
+
+        Node(unsigned x, unsigned y) : m_x{x}, m_y{y}, m_paths(0U)
+        {
+            // auto idx = calculate_idx(m_x, m_y);
+            // std::cout << "at(" << idx << ") = Node(" << x << "," << y << ")\n";
+            if (x + 1U < WIDTH)
+            {
+                m_left_neighbour_idx = calculate_idx(x + 1U, y);
+                // std::cout << "has neighbout left with idx = " << m_left_neighbour_idx.value() << "\n";
+            }
+            if (y + 1U < HEIGHT)
+            {
+                m_down_neighbour_idx = calculate_idx(x, y + 1U);
+                // std::cout << "has neighbout down with idx = " << m_down_neighbour_idx.value() << "\n";
+            }
+        }
+
+        static unsigned long calculate_idx(unsigned x, unsigned y) noexcept { return x + y * WIDTH; }
+
+        unsigned m_x{0U};
+        unsigned m_y{0U};
+        unsigned long m_paths{0U};
+        std::optional<unsigned> m_left_neighbour_idx;
+        std::optional<unsigned> m_down_neighbour_idx;
+    };
+
+    template <unsigned WIDTH, unsigned HEIGHT>
+    auto build_nodes() -> std::array<Node<WIDTH, HEIGHT>, WIDTH * HEIGHT>
+    {
+        std::array<Node<WIDTH, HEIGHT>, WIDTH * HEIGHT> grid{};
+        for (unsigned i = 0U; i < WIDTH; ++i)
+        {
+            for (unsigned j = 0U; j < HEIGHT; ++j)
+            {
+                grid[Node<WIDTH, HEIGHT>::calculate_idx(i, j)] = Node<WIDTH, HEIGHT>(i, j);
+            }
+        }
+
+        return grid;
+    }
+
+    // Same as Node, for grid size known at runtime
+    struct Grid_node
+    {
+        Grid_node() = default;
+
+        Grid_node(unsigned x, unsigned y, unsigned width, unsigned height) : m_x{x}, m_y{y}, m_paths(0U)
+        {
+            if (x + 1U < width)
+            {
+                m_left_neighbour_idx = calculate_idx(x + 1U, y, width);
+            }
+            if (y + 1U < height)
+            {
+                m_down_neighbour_idx = calculate_idx(x, y + 1U, width);
+            }
+        }
+
+        static unsigned long calculate_idx(unsigned x, unsigned y, unsigned width) noexcept { return x + static_cast<unsigned long>(y) * width; }
+
+        unsigned m_x{0U};
+        unsigned m_y{0U};
+        unsigned long m_paths{0U};
+        std::optional<unsigned> m_left_neighbour_idx;
+        std::optional<unsigned> m_down_neighbour_idx;
+    };
+
+    // Nodes on the heap, width * height of them
+    inline auto build_nodes(unsigned width, unsigned height) -> std::vector<Grid_node>
+    {
+        std::vector<Grid_node> grid(static_cast<size_t>(width) * height);
+        for (unsigned i = 0U; i < width; ++i)
+        {
+            for (unsigned j = 0U; j < height; ++j)
+            {
+                grid[Grid_node::calculate_idx(i, j, width)] = Grid_node(i, j, width, height);
+            }
+        }
+
+        return grid;
+    }
+}
+
+namespace Brute
+{
+    using Common::Node;
+
+    // Recursive, all possibilities; nodes from any of Common::build_nodes
+    template <typename GridNode, typename Nodes>
+    void calculate_paths(const GridNode &node, const Nodes &nodes, unsigned long &paths)
+    {
+        if (node.m_left_neighbour_idx.has_value())
+        {
+            calculate_paths(nodes[node.m_left_neighbour_idx.value()], nodes, paths);
+        }
+
+        if (node.m_down_neighbour_idx.has_value())
+        {
+            calculate_paths(nodes[node.m_down_neighbour_idx.value()], nodes, paths);
+        }
+
+        if (!node.m_down_neighbour_idx.has_value() && !node.m_left_neighbour_idx.has_value())
+        {
+            ++paths;
+        }
+    }
+}
+
+namespace Memoized
+{
+    // Same as Brute, but paths from each node are counted once and remembered (top-down dynamic programming);
+    // works for any acyclic nodes, not only grids. Explicit stack instead of recursion, so the depth of paths
+    // isn't limited by the call stack.
+    template <typename GridNode, typename Nodes>
+    void calculate_paths(const GridNode &node, const Nodes &nodes, unsigned long &paths)
+    {
+        std::vector<unsigned long> node_paths(nodes.size(), 0UL);
+        std::vector<bool> known(nodes.size(), false);
+
+        const auto node_idx = static_cast<size_t>(&node - &nodes[0]);
+        std::vector<size_t> stack{node_idx};
+
+        while (!stack.empty())
+        {
+            const size_t idx = stack.back();
+            const auto &current = nodes[idx];
+
+            // Neighbours first; a node may be pushed again by another parent before it is counted
+            bool neighbours_known = true;
+            for (const auto &neighbour_idx : {current.m_left_neighbour_idx, current.m_down_neighbour_idx})
+            {
+                if (neighbour_idx.has_value() && !known[neighbour_idx.value()])
+                {
+                    stack.push_back(neighbour_idx.value());
+                    neighbours_known = false;
+                }
+            }
+            if (!neighbours_known)
+            {
+                continue;
+            }
+
+            stack.pop_back();
+            if (known[idx])
+            {
+                continue;
+            }
+
+            if (!current.m_left_neighbour_idx.has_value() && !current.m_down_neighbour_idx.has_value())
+            {
+                node_paths[idx] = 1UL;
+            }
+            else
+            {
+                for (const auto &neighbour_idx : {current.m_left_neighbour_idx, current.m_down_neighbour_idx})
+                {
+                    if (neighbour_idx.has_value())
+                    {
+                        node_paths[idx] += node_paths[neighbour_idx.value()];
+                    }
+                }
+            }
+            known[idx] = true;
+        }
+
+        paths = node_paths[node_idx];
+    }
+}
+
+namespace Better
+{
+    using Common::Node;
+
+    // Iterates once; nodes from any of Common::build_nodes
+    template <typename Nodes>
+    void calculate_paths(Nodes &nodes, unsigned long &paths)
+    {
+        nodes[0].m_paths = 1; // first path
+
+        // Each node has as many possible paths as its parents
+        for (auto &node : nodes)
+        {
+            // std::cout << "at(" << node.m_x << ", " << node.m_y << ") = " << node.m_weight << "\n";
+            if (node.m_left_neighbour_idx.has_value())
+            {
+                nodes[node.m_left_neighbour_idx.value()].m_paths += node.m_paths;
+            }
+
+            if (node.m_down_neighbour_idx.has_value())
+            {
+                nodes[node.m_down_neighbour_idx.value()].m_paths += node.m_paths;
+            }
+        }
+
+        paths = nodes.back().m_paths;
+    }
+
+    // Grid of width x height cells known at runtime, no nodes: only a single row of path counts is kept.
+    // Node has as many paths as the one above (same entry of the row) and the one on the left (previous entry).
+    // Paths are symmetric, so the shorter side is the row.
+    // Count is unsigned long or Common::Big_number when exact result is needed for big grids;
+    // 32 and 64-bit counts use the vectorized sweep.
+    template <typename Count>
+    void calculate_paths(unsigned width, unsigned height, Count &paths)
+    {
+        if (width > height)
+        {
+            std::swap(width, height);
+        }
+
+        std::vector<Count> row(width + 1U, Count{1U});
+        for (unsigned y = 0U; y < height; ++y)
+        {
+            if constexpr (std::is_unsigned_v<Count> && (sizeof(Count) == 4U || sizeof(Count) == 8U))
+            {
+                sweep_row(row.data(), row.size());
+            }
+            else
+            {
+                for (size_t x = 1U; x < row.size(); ++x)
+                {
+                    row[x] += row[x - 1U];
+                }
+            }
+        }
+
+        paths = row.back();
+    }
+
+}
+
+namespace Math
+{
+    template <size_t NUM>
+    struct power2
+    {
+        static constexpr size_t m_value = NUM * NUM;
+    };
+
+    template <unsigned long NUM>
+    struct factorial
+    {
+        static constexpr size_t m_value = NUM * factorial<NUM - 1U>::m_value;
+    };
+
+    template <>
+    struct factorial<0>
+    {
+        static constexpr size_t m_value = 1U;
+    };
+
+    template <unsigned WIDTH, unsigned HEIGHT>
+    void calculate_paths_factorial(unsigned long &paths)
+    {
+        constexpr unsigned long grid_width = WIDTH - 1U;
+
+        // with central binomial coefficient; too big numbers generated, not a good way
+        paths = (factorial<2U * grid_width>::m_value) / (power2<factorial<grid_width>::m_value>::m_value);
+    }
+
+    template <unsigned WIDTH, unsigned HEIGHT>
+    void calculate_paths(double &paths)
+    {
+        constexpr unsigned long grid_width = WIDTH;
+
+        // with central binomial coefficient - other version
+        //std::cout << "grid_width = " << grid_width << "\n";
+        paths = 1;
+        for (size_t k = 1; k <= grid_width; ++k) {
+            paths *= static_cast<double>(grid_width + k)/k;
+        }
+    }
+
+    // Grid of width x height cells (not nodes) known at runtime, binomial coefficient (width + height, height)
+    inline void calculate_paths(unsigned width, unsigned height, double &paths)
+    {
+        paths = 1;
+        for (size_t k = 1; k <= height; ++k) {
+            paths *= static_cast<double>(width + k)/k;
+        }
+    }
+
+    // Exact, each step is binomial coefficient (width + k, k) so the division has no remainder
+    inline void calculate_paths(unsigned width, unsigned height, Common::Big_number &paths)
+    {
+        if (width < height)
+        {
+            std::swap(width, height);
+        }
+
+        paths = 1U;
+        for (uint64_t k = 1U; k <= height; ++k)
+        {
+            paths *= width + k;
+            paths /= k;
+        }
+    }
+}
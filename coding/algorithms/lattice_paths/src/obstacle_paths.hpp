@@ -0,0 +1,161 @@
+#pragma once
+
+#include <algorithm>
+#include <barrier>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+namespace Common
+{
+    // Blocked nodes of a grid of width x height nodes (not cells), a bit per node
+    class Obstacle_map
+    {
+    public:
+        Obstacle_map(unsigned width, unsigned height)
+            : m_width{width}, m_height{height}, m_row_words{(width + 63U) / 64U}, m_bits(static_cast<size_t>(m_row_words) * height, 0U)
+        {
+        }
+
+        void block(unsigned x, unsigned y) noexcept { m_bits[word_idx(x, y)] |= uint64_t{1U} << (x % 64U); }
+
+        void unblock(unsigned x, unsigned y) noexcept { m_bits[word_idx(x, y)] &= ~(uint64_t{1U} << (x % 64U)); }
+
+        bool is_blocked(unsigned x, unsigned y) const noexcept { return (m_bits[word_idx(x, y)] >> (x % 64U)) & 1U; }
+
+        unsigned width() const noexcept { return m_width; }
+
+        unsigned height() const noexcept { return m_height; }
+
+    private:
+        size_t word_idx(unsigned x, unsigned y) const noexcept { return static_cast<size_t>(y) * m_row_words + x / 64U; }
+
+        unsigned m_width;
+        unsigned m_height;
+        unsigned m_row_words;
+        std::vector<uint64_t> m_bits;
+    };
+}
+
+namespace Better
+{
+    // Paths from top left to bottom right node going around blocked nodes; a blocked node has no paths.
+    // Single row of counts, as for grids without obstacles.
+    template <typename Count>
+    void calculate_paths_sweep(const Common::Obstacle_map &obstacles, Count &paths)
+    {
+        if (obstacles.width() == 0U || obstacles.height() == 0U)
+        {
+            paths = Count{0U};
+            return;
+        }
+
+        // Virtual row above the grid, leads into the first node only
+        std::vector<Count> row(obstacles.width(), Count{0U});
+        row[0] = Count{1U};
+
+        for (unsigned y = 0U; y < obstacles.height(); ++y)
+        {
+            Count left{0U};
+            for (unsigned x = 0U; x < obstacles.width(); ++x)
+            {
+                if (obstacles.is_blocked(x, y))
+                {
+                    row[x] = Count{0U};
+                }
+                else
+                {
+                    row[x] += left;
+                }
+                left = row[x];
+            }
+        }
+
+        paths = row.back();
+    }
+
+    // Same, grid split into tiles of tile_size x tile_size nodes processed in waves: tile depends only on the tiles
+    // above and on the left, so tiles on the same anti-diagonal are independent and shared among threads.
+    // Tile reads and writes its part of the row (bottom edge of the tile above) and of the column (right edge
+    // of the tile on the left), so the working set is a tile no matter how big the grid is.
+    // threads = 0 means all hardware threads.
+    template <typename Count>
+    void calculate_paths_wavefront(const Common::Obstacle_map &obstacles, Count &paths, unsigned threads = 0U, unsigned tile_size = 256U)
+    {
+        const unsigned width = obstacles.width();
+        const unsigned height = obstacles.height();
+        if (width == 0U || height == 0U)
+        {
+            paths = Count{0U};
+            return;
+        }
+
+        tile_size = std::max(tile_size, 1U);
+        const unsigned tiles_x = (width + tile_size - 1U) / tile_size;
+        const unsigned tiles_y = (height + tile_size - 1U) / tile_size;
+        const unsigned waves = tiles_x + tiles_y - 1U;
+
+        if (threads == 0U)
+        {
+            threads = std::max(std::thread::hardware_concurrency(), 1U);
+        }
+        threads = std::min(threads, std::min(tiles_x, tiles_y));
+
+        std::vector<Count> row(width, Count{0U});
+        std::vector<Count> column(height, Count{0U});
+        row[0] = Count{1U};
+
+        auto process_tile = [&](unsigned tile_x, unsigned tile_y)
+        {
+            const unsigned x_begin = tile_x * tile_size;
+            const unsigned x_end = std::min(x_begin + tile_size, width);
+            const unsigned y_begin = tile_y * tile_size;
+            const unsigned y_end = std::min(y_begin + tile_size, height);
+
+            for (unsigned y = y_begin; y < y_end; ++y)
+            {
+                Count left = x_begin > 0U ? column[y] : Count{0U};
+                for (unsigned x = x_begin; x < x_end; ++x)
+                {
+                    if (obstacles.is_blocked(x, y))
+                    {
+                        row[x] = Count{0U};
+                    }
+                    else
+                    {
+                        row[x] += left;
+                    }
+                    left = row[x];
+                }
+                column[y] = left;
+            }
+        };
+
+        // Thread takes every threads-th tile of a wave, all wait for the wave to finish
+        std::barrier wave_done{static_cast<std::ptrdiff_t>(threads)};
+        auto worker = [&](unsigned thread)
+        {
+            for (unsigned wave = 0U; wave < waves; ++wave)
+            {
+                const unsigned first_tile_x = wave < tiles_y ? 0U : wave - tiles_y + 1U;
+                const unsigned last_tile_x = std::min(wave, tiles_x - 1U);
+                for (unsigned tile_x = first_tile_x + thread; tile_x <= last_tile_x; tile_x += threads)
+                {
+                    process_tile(tile_x, wave - tile_x);
+                }
+                wave_done.arrive_and_wait();
+            }
+        };
+
+        std::vector<std::jthread> workers;
+        for (unsigned thread = 1U; thread < threads; ++thread)
+        {
+            workers.emplace_back(worker, thread);
+        }
+        worker(0U);
+        workers.clear();
+
+        paths = row.back();
+    }
+}
@@ -0,0 +1,159 @@
+#pragma once
+
+#include "binomial.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <stdexcept>
+#include <vector>
+
+namespace Math
+{
+    // Width x height in cells
+    struct Grid_size
+    {
+        unsigned m_width{0U};
+        unsigned m_height{0U};
+    };
+
+    // Answers path count queries from caches shared by all queries (and threads), instead of computing
+    // each from scratch. Both caches grow lazily to the largest grid asked for:
+    //  - Pascal triangle, exact counts while they fit in unsigned long (width + height up to 67),
+    //  - factorials and inverse factorials modulo prime, any size, grown by doubling.
+    // A batch takes the lock once and grows caches once, so the per-query cost is a lookup.
+    class Path_cache
+    {
+    public:
+        // (68, 34) doesn't fit in 64 bits
+        static constexpr unsigned MAX_EXACT_N = 67U;
+
+        unsigned long paths(unsigned width, unsigned height)
+        {
+            const unsigned n = exact_n(width, height);
+            grow_triangle(n);
+
+            std::shared_lock lock{m_mutex};
+            return pascal(n, height);
+        }
+
+        uint32_t paths_mod(unsigned width, unsigned height)
+        {
+            grow_factorials(width + height);
+
+            std::shared_lock lock{m_mutex};
+            return (*m_binomial_mod)(width + height, height);
+        }
+
+        void paths(const std::vector<Grid_size> &grids, std::vector<unsigned long> &results)
+        {
+            unsigned max_n{0U};
+            for (const auto &grid : grids)
+            {
+                max_n = std::max(max_n, exact_n(grid.m_width, grid.m_height));
+            }
+            grow_triangle(max_n);
+
+            results.resize(grids.size());
+
+            std::shared_lock lock{m_mutex};
+            for (size_t i = 0U; i < grids.size(); ++i)
+            {
+                results[i] = pascal(grids[i].m_width + grids[i].m_height, grids[i].m_height);
+            }
+        }
+
+        void paths_mod(const std::vector<Grid_size> &grids, std::vector<uint32_t> &results)
+        {
+            unsigned max_n{0U};
+            for (const auto &grid : grids)
+            {
+                max_n = std::max(max_n, grid.m_width + grid.m_height);
+            }
+            grow_factorials(max_n);
+
+            results.resize(grids.size());
+
+            std::shared_lock lock{m_mutex};
+            const auto &binomial_mod = *m_binomial_mod;
+            for (size_t i = 0U; i < grids.size(); ++i)
+            {
+                results[i] = binomial_mod(grids[i].m_width + grids[i].m_height, grids[i].m_height);
+            }
+        }
+
+        uint32_t modulus() const noexcept { return Binomial_mod::DEFAULT_MODULUS; }
+
+    private:
+        static unsigned exact_n(unsigned width, unsigned height)
+        {
+            if (width + height > MAX_EXACT_N)
+            {
+                throw std::out_of_range("Path_cache: paths don't fit in unsigned long");
+            }
+            return width + height;
+        }
+
+        // Rows are stored one after another, row n starts at n * (n + 1) / 2
+        unsigned long pascal(unsigned n, unsigned k) const noexcept
+        {
+            return m_triangle[static_cast<size_t>(n) * (n + 1U) / 2U + k];
+        }
+
+        void grow_triangle(unsigned n)
+        {
+            {
+                std::shared_lock lock{m_mutex};
+                if (n < m_triangle_rows)
+                {
+                    return;
+                }
+            }
+
+            std::unique_lock lock{m_mutex};
+            if (n < m_triangle_rows)
+            {
+                return;
+            }
+
+            m_triangle.resize(static_cast<size_t>(n + 1U) * (n + 2U) / 2U);
+            for (unsigned row = m_triangle_rows; row <= n; ++row)
+            {
+                const size_t begin = static_cast<size_t>(row) * (row + 1U) / 2U;
+                m_triangle[begin] = 1UL;
+                m_triangle[begin + row] = 1UL;
+                for (unsigned k = 1U; k < row; ++k)
+                {
+                    m_triangle[begin + k] = pascal(row - 1U, k - 1U) + pascal(row - 1U, k);
+                }
+            }
+            m_triangle_rows = n + 1U;
+        }
+
+        void grow_factorials(unsigned n)
+        {
+            {
+                std::shared_lock lock{m_mutex};
+                if (m_binomial_mod && n <= m_binomial_mod->max_n())
+                {
+                    return;
+                }
+            }
+
+            std::unique_lock lock{m_mutex};
+            if (!m_binomial_mod || n > m_binomial_mod->max_n())
+            {
+                const uint32_t max_n = m_binomial_mod ? std::max(n, 2U * m_binomial_mod->max_n()) : n;
+                m_binomial_mod.emplace(max_n);
+            }
+        }
+
+        std::shared_mutex m_mutex;
+        std::vector<unsigned long> m_triangle;
+        unsigned m_triangle_rows{0U};
+        std::optional<Binomial_mod> m_binomial_mod;
+    };
+}
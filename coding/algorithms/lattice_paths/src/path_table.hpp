@@ -0,0 +1,55 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <stdexcept>
+
+namespace Math
+{
+    __extension__ typedef unsigned __int128 uint128_t;
+
+    // Pascal triangle rows up to n = width + height where all the grids still fit in 128 bits,
+    // (132, 66) doesn't. Row n starts at n * (n + 1) / 2.
+    inline constexpr unsigned MAX_TABLE_N = 131U;
+    inline constexpr size_t PATH_TABLE_SIZE = (MAX_TABLE_N + 1U) * (MAX_TABLE_N + 2U) / 2U;
+
+    consteval std::array<uint128_t, PATH_TABLE_SIZE> make_path_table()
+    {
+        std::array<uint128_t, PATH_TABLE_SIZE> table{};
+        table[0] = 1U;
+        for (size_t n = 1U; n <= MAX_TABLE_N; ++n)
+        {
+            const size_t row = n * (n + 1U) / 2U;
+            const size_t previous_row = row - n;
+            table[row] = 1U;
+            table[row + n] = 1U;
+            for (size_t k = 1U; k < n; ++k)
+            {
+                table[row + k] = table[previous_row + k - 1U] + table[previous_row + k];
+            }
+        }
+        return table;
+    }
+
+    // Computed at compile time, 140 KB of read-only data
+    inline constexpr auto PATH_TABLE = make_path_table();
+
+    // Grid of width x height cells, a single load
+    constexpr uint128_t table_paths(unsigned width, unsigned height)
+    {
+        const size_t n = static_cast<size_t>(width) + height;
+        if (n > MAX_TABLE_N)
+        {
+            throw std::out_of_range("table_paths: grid too big for the table");
+        }
+        return PATH_TABLE[n * (n + 1U) / 2U + height];
+    }
+
+    // Same as a template metaprogram, unlike factorial<> it doesn't overflow
+    template <unsigned WIDTH, unsigned HEIGHT>
+    struct path_count
+    {
+        static_assert(WIDTH + HEIGHT <= MAX_TABLE_N, "path_count: grid too big for the table");
+        static constexpr uint128_t m_value = PATH_TABLE[(WIDTH + HEIGHT) * (WIDTH + HEIGHT + 1U) / 2U + HEIGHT];
+    };
+}
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define LATTICE_PATHS_X86 1
+#endif
+
+// One step of the single row DP, row[i] += row[i - 1] from left to right: in place prefix sum of the row.
+// Vectorized with AVX2 when the CPU has it (checked at runtime, no special compile flags needed).
+
+namespace Better
+{
+    namespace detail
+    {
+        template <typename Count>
+        void sweep_row_scalar(Count *row, size_t size) noexcept
+        {
+            for (size_t i = 1U; i < size; ++i)
+            {
+                row[i] += row[i - 1U];
+            }
+        }
+
+#ifdef LATTICE_PATHS_X86
+        // Prefix sum of each vector is computed in registers (log steps of shifting and adding), independently of
+        // other vectors; only adding the running total is a dependency between iterations.
+
+        __attribute__((target("avx2"))) inline void sweep_row_avx2(uint64_t *row, size_t size) noexcept
+        {
+            const __m256i zero = _mm256_setzero_si256();
+            __m256i total = zero;
+
+            size_t i = 0U;
+            for (; i + 4U <= size; i += 4U)
+            {
+                __m256i sums = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(row + i));
+                // [a, b, c, d] + [0, a, b, c] + [0, 0, a, a + b]
+                sums = _mm256_add_epi64(sums, _mm256_blend_epi32(_mm256_permute4x64_epi64(sums, _MM_SHUFFLE(2, 1, 0, 0)), zero, 0x03));
+                sums = _mm256_add_epi64(sums, _mm256_blend_epi32(_mm256_permute4x64_epi64(sums, _MM_SHUFFLE(1, 0, 0, 0)), zero, 0x0F));
+
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(row + i), _mm256_add_epi64(sums, total));
+                total = _mm256_add_epi64(total, _mm256_permute4x64_epi64(sums, _MM_SHUFFLE(3, 3, 3, 3)));
+            }
+
+            uint64_t last = i > 0U ? row[i - 1U] : 0U;
+            for (; i < size; ++i)
+            {
+                last += row[i];
+                row[i] = last;
+            }
+        }
+
+        __attribute__((target("avx2"))) inline void sweep_row_avx2(uint32_t *row, size_t size) noexcept
+        {
+            const __m256i zero = _mm256_setzero_si256();
+            const __m256i last_lane = _mm256_set1_epi32(7);
+            __m256i total = zero;
+
+            size_t i = 0U;
+            for (; i + 8U <= size; i += 8U)
+            {
+                __m256i sums = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(row + i));
+                // Within 128-bit halves by byte shifts, then last sum of the lower half added to the upper one
+                sums = _mm256_add_epi32(sums, _mm256_slli_si256(sums, 4));
+                sums = _mm256_add_epi32(sums, _mm256_slli_si256(sums, 8));
+                sums = _mm256_add_epi32(sums, _mm256_shuffle_epi32(_mm256_permute2x128_si256(sums, sums, 0x08), _MM_SHUFFLE(3, 3, 3, 3)));
+
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(row + i), _mm256_add_epi32(sums, total));
+                total = _mm256_add_epi32(total, _mm256_permutevar8x32_epi32(sums, last_lane));
+            }
+
+            uint32_t last = i > 0U ? row[i - 1U] : 0U;
+            for (; i < size; ++i)
+            {
+                last += row[i];
+                row[i] = last;
+            }
+        }
+
+        inline bool has_avx2() noexcept
+        {
+            return __builtin_cpu_supports("avx2");
+        }
+#endif
+    }
+
+    // Kernel selected once, on first call
+    template <typename Count>
+    void sweep_row(Count *row, size_t size) noexcept
+    {
+        static_assert(sizeof(Count) == sizeof(uint32_t) || sizeof(Count) == sizeof(uint64_t), "32 or 64-bit counts supported.");
+
+#ifdef LATTICE_PATHS_X86
+        using Lane = std::conditional_t<sizeof(Count) == sizeof(uint32_t), uint32_t, uint64_t>;
+        using Kernel = void (*)(Lane *, size_t) noexcept;
+
+        static const Kernel kernel = detail::has_avx2() ? static_cast<Kernel>(detail::sweep_row_avx2) : detail::sweep_row_scalar<Lane>;
+        kernel(reinterpret_cast<Lane *>(row), size);
+#else
+        detail::sweep_row_scalar(row, size);
+#endif
+    }
+}
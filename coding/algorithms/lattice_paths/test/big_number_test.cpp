@@ -0,0 +1,56 @@
+#include <big_number.hpp>
+
+#include <gtest/gtest.h>
+
+using Common::Big_number;
+
+TEST(Big_number, test_to_string)
+{
+    EXPECT_EQ(Big_number{}.to_string(), "0");
+    EXPECT_EQ(Big_number{7U}.to_string(), "7");
+    EXPECT_EQ(Big_number{10000000000000000000U}.to_string(), "10000000000000000000");
+    EXPECT_EQ(Big_number{18446744073709551615U}.to_string(), "18446744073709551615");
+}
+
+TEST(Big_number, test_add)
+{
+    Big_number number{18446744073709551615U};
+    number += Big_number{1U};
+    EXPECT_EQ(number.to_string(), "18446744073709551616");
+    EXPECT_EQ(number.limbs().size(), 2U);
+
+    number += number;
+    EXPECT_EQ(number.to_string(), "36893488147419103232");
+
+    Big_number small{5U};
+    small += number;
+    EXPECT_EQ(small.to_string(), "36893488147419103237");
+
+    Big_number zero;
+    zero += Big_number{};
+    EXPECT_TRUE(zero.is_zero());
+}
+
+TEST(Big_number, test_multiply_divide)
+{
+    // 30!
+    Big_number factorial{1U};
+    for (uint64_t i = 2U; i <= 30U; ++i)
+    {
+        factorial *= i;
+    }
+    EXPECT_EQ(factorial.to_string(), "265252859812191058636308480000000");
+
+    for (uint64_t i = 30U; i >= 2U; --i)
+    {
+        EXPECT_EQ(factorial.divide(i), 0U);
+    }
+    EXPECT_EQ(factorial, Big_number{1U});
+
+    Big_number number{100U};
+    EXPECT_EQ(number.divide(7U), 2U);
+    EXPECT_EQ(number, Big_number{14U});
+
+    number *= 0U;
+    EXPECT_TRUE(number.is_zero());
+}
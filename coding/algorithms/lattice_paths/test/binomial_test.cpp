@@ -0,0 +1,60 @@
+#include <binomial.hpp>
+#include <lattice_paths.hpp>
+
+#include <gtest/gtest.h>
+
+TEST(Binomial, test_sieve_primes)
+{
+    EXPECT_EQ(Math::sieve_primes(30U), (std::vector<uint32_t>{2U, 3U, 5U, 7U, 11U, 13U, 17U, 19U, 23U, 29U}));
+    EXPECT_EQ(Math::sieve_primes(2U), (std::vector<uint32_t>{2U}));
+    EXPECT_TRUE(Math::sieve_primes(1U).empty());
+    EXPECT_EQ(Math::sieve_primes(100000U).size(), 9592U);
+}
+
+TEST(Binomial, test_binomial)
+{
+    const Math::Binomial binomial{1000U};
+
+    EXPECT_EQ(binomial(40U, 20U).to_string(), "137846528820");
+    EXPECT_EQ(binomial(100U, 50U).to_string(), "100891344545564193334812497256");
+    EXPECT_EQ(binomial(5U, 0U), Common::Big_number{1U});
+    EXPECT_EQ(binomial(5U, 5U), Common::Big_number{1U});
+    EXPECT_EQ(binomial(0U, 0U), Common::Big_number{1U});
+    EXPECT_TRUE(binomial(5U, 6U).is_zero());
+    EXPECT_THROW(binomial(1001U, 1U), std::out_of_range);
+
+    for (unsigned width = 0U; width < 500U; width += 37U)
+    {
+        for (unsigned height = 0U; height < 500U; height += 41U)
+        {
+            Common::Big_number paths;
+            Math::calculate_paths(width, height, paths);
+            EXPECT_EQ(binomial(width + height, height), paths);
+        }
+    }
+}
+
+TEST(Binomial, test_binomial_mod)
+{
+    const Math::Binomial_mod binomial_mod{1000U};
+    const Math::Binomial binomial{1000U};
+
+    EXPECT_EQ(binomial_mod(40U, 20U), 137846528820U % Math::Binomial_mod::DEFAULT_MODULUS);
+    EXPECT_EQ(binomial_mod(5U, 6U), 0U);
+    EXPECT_EQ(binomial_mod.max_n(), 1000U);
+    EXPECT_THROW(binomial_mod(1001U, 1U), std::out_of_range);
+
+    for (uint32_t n = 0U; n <= 1000U; n += 13U)
+    {
+        for (uint32_t k = 0U; k <= n; k += 7U)
+        {
+            auto exact = binomial(n, k);
+            EXPECT_EQ(binomial_mod(n, k), exact.divide(binomial_mod.modulus()));
+        }
+    }
+
+    // Small prime modulus
+    const Math::Binomial_mod binomial_mod_13{12U, 13U};
+    EXPECT_EQ(binomial_mod_13(12U, 6U), 924U % 13U);
+    EXPECT_THROW((Math::Binomial_mod{13U, 13U}), std::invalid_argument);
+}
@@ -0,0 +1,79 @@
+#include <box_paths.hpp>
+#include <lattice_paths.hpp>
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <vector>
+
+TEST(Box_paths, test_small_boxes)
+{
+    unsigned long paths{0UL};
+
+    Better::calculate_box_paths(std::vector<unsigned>{}, paths);
+    EXPECT_EQ(paths, 1UL);
+
+    Better::calculate_box_paths(std::vector<unsigned>{5U}, paths);
+    EXPECT_EQ(paths, 1UL);
+
+    // 3!/(1!1!1!)
+    Better::calculate_box_paths(std::vector<unsigned>{1U, 1U, 1U}, paths);
+    EXPECT_EQ(paths, 6UL);
+
+    // 6!/(2!2!2!)
+    Better::calculate_box_paths(std::vector<unsigned>{2U, 2U, 2U}, paths);
+    EXPECT_EQ(paths, 90UL);
+
+    // 6!/(1!2!3!)
+    Better::calculate_box_paths(std::vector<unsigned>{1U, 2U, 3U}, paths);
+    EXPECT_EQ(paths, 60UL);
+
+    // 8!/(2!2!2!2!)
+    Better::calculate_box_paths(std::vector<unsigned>{2U, 2U, 2U, 2U}, paths);
+    EXPECT_EQ(paths, 2520UL);
+
+    Better::calculate_box_paths(std::vector<unsigned>{3U, 0U, 4U}, paths);
+    EXPECT_EQ(paths, 35UL);
+}
+
+TEST(Box_paths, test_matches_grid)
+{
+    for (unsigned width = 0U; width <= 20U; ++width)
+    {
+        for (unsigned height = 0U; height <= 20U; ++height)
+        {
+            unsigned long expected{0UL};
+            Better::calculate_paths(width, height, expected);
+
+            unsigned long paths{0UL};
+            Better::calculate_box_paths(std::vector<unsigned>{width, height}, paths);
+            EXPECT_EQ(paths, expected);
+
+            Better::calculate_box_paths(std::vector<unsigned>{width, 0U, height}, paths);
+            EXPECT_EQ(paths, expected);
+        }
+    }
+}
+
+TEST(Box_paths, test_closed_form)
+{
+    const std::vector<std::vector<unsigned>> boxes{{7U, 3U, 5U}, {4U, 4U, 4U, 4U}, {1U, 6U, 2U, 3U}, {10U, 9U, 8U, 2U, 1U}, {30U, 30U, 30U}};
+    for (const auto &box : boxes)
+    {
+        Common::Big_number expected;
+        Better::calculate_box_paths(box, expected);
+
+        Common::Big_number paths;
+        Math::calculate_box_paths(box, paths);
+        EXPECT_EQ(paths.to_string(), expected.to_string());
+
+        double approximate{0.0};
+        Math::calculate_box_paths(box, approximate);
+        EXPECT_NEAR(approximate, std::stod(expected.to_string()), std::stod(expected.to_string()) * 1e-12);
+    }
+
+    // 60!/(20!20!20!)
+    Common::Big_number paths;
+    Math::calculate_box_paths(std::vector<unsigned>{20U, 20U, 20U}, paths);
+    EXPECT_EQ(paths.to_string(), "577831214478475823831865900");
+}
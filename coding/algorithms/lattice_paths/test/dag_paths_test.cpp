@@ -0,0 +1,105 @@
+#include <dag_paths.hpp>
+#include <lattice_paths.hpp>
+
+#include <gtest/gtest.h>
+
+#include <random>
+#include <stdexcept>
+
+namespace
+{
+    Common::Dag random_dag(unsigned nodes, unsigned edges_per_node, unsigned seed)
+    {
+        std::mt19937 generator{seed};
+        std::uniform_int_distribution<unsigned> distance{1U, 16U};
+        std::vector<Common::Dag::Edge> edges;
+        for (unsigned node = 0U; node + 1U < nodes; ++node)
+        {
+            for (unsigned edge = 0U; edge < edges_per_node; ++edge)
+            {
+                edges.emplace_back(node, std::min(node + distance(generator), nodes - 1U));
+            }
+        }
+        return Common::Dag{nodes, edges};
+    }
+}
+
+TEST(Dag_paths, test_diamond)
+{
+    // 0 -> 1 -> 3, 0 -> 2 -> 3, 1 -> 2
+    const Common::Dag dag{4U, {{0U, 1U}, {0U, 2U}, {1U, 3U}, {2U, 3U}, {1U, 2U}}};
+
+    EXPECT_EQ(dag.size(), 4U);
+    EXPECT_EQ(dag.edges_count(), 5U);
+    EXPECT_EQ(dag.levels(), 4U);
+    EXPECT_EQ(dag.successors(1U).size(), 2U);
+    EXPECT_EQ(dag.predecessors(2U).size(), 2U);
+
+    unsigned long paths{0UL};
+    Better::calculate_paths(dag, 0U, 3U, paths);
+    EXPECT_EQ(paths, 3UL);
+
+    Better::calculate_paths(dag, 1U, 3U, paths);
+    EXPECT_EQ(paths, 2UL);
+
+    Better::calculate_paths(dag, 3U, 0U, paths);
+    EXPECT_EQ(paths, 0UL);
+
+    Better::calculate_paths_levels(dag, 0U, 3U, paths, 2U);
+    EXPECT_EQ(paths, 3UL);
+}
+
+TEST(Dag_paths, test_invalid_graph)
+{
+    EXPECT_THROW((Common::Dag{3U, {{0U, 1U}, {1U, 2U}, {2U, 0U}}}), std::invalid_argument);
+    EXPECT_THROW((Common::Dag{2U, {{0U, 2U}}}), std::out_of_range);
+    EXPECT_THROW((Common::Dag{0U, {{0U, 0U}}}), std::out_of_range);
+}
+
+TEST(Dag_paths, test_empty_graph)
+{
+    const Common::Dag dag{0U, {}};
+    EXPECT_EQ(dag.size(), 0U);
+    EXPECT_EQ(dag.edges_count(), 0U);
+    EXPECT_EQ(dag.levels(), 0U);
+    EXPECT_TRUE(dag.topological_order().empty());
+
+    unsigned long paths{0U};
+    EXPECT_THROW(Better::calculate_paths(dag, 0U, 0U, paths), std::out_of_range);
+    EXPECT_THROW(Better::calculate_paths_levels(dag, 0U, 0U, paths, 2U), std::out_of_range);
+}
+
+TEST(Dag_paths, test_grid)
+{
+    for (unsigned size = 2U; size <= 21U; ++size)
+    {
+        const auto dag = Common::build_dag(size, size);
+        EXPECT_EQ(dag.levels(), 2U * size - 1U);
+
+        unsigned long expected{0UL};
+        Better::calculate_paths(size - 1U, size - 1U, expected);
+
+        unsigned long paths{0UL};
+        Better::calculate_paths(dag, 0U, dag.size() - 1U, paths);
+        EXPECT_EQ(paths, expected);
+
+        Better::calculate_paths_levels(dag, 0U, dag.size() - 1U, paths, 3U);
+        EXPECT_EQ(paths, expected);
+    }
+}
+
+TEST(Dag_paths, test_levels_match_sequential)
+{
+    const auto dag = random_dag(5000U, 3U, 7U);
+
+    Common::Big_number expected;
+    Better::calculate_paths(dag, 0U, dag.size() - 1U, expected);
+    EXPECT_FALSE(expected.is_zero());
+
+    for (unsigned threads = 1U; threads <= 4U; ++threads)
+    {
+        Common::Big_number paths;
+        Better::calculate_paths_levels(dag, 0U, dag.size() - 1U, paths, threads);
+        EXPECT_EQ(paths, expected);
+    }
+}
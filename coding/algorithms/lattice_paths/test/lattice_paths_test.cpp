@@ -0,0 +1,133 @@
+#include <lattice_paths.hpp>
+
+#include <gtest/gtest.h>
+
+TEST(Lattice_paths, test_brute)
+{
+    unsigned long paths{0UL};
+    auto nodes = Common::build_nodes<3U, 3U>();
+    Brute::calculate_paths(nodes[0], nodes, paths);
+    EXPECT_EQ(paths, 6UL);
+
+    paths = 0UL;
+    auto grid_nodes = Common::build_nodes(4U, 3U);
+    Brute::calculate_paths(grid_nodes[0], grid_nodes, paths);
+    EXPECT_EQ(paths, 10UL);
+}
+
+TEST(Lattice_paths, test_memoized)
+{
+    unsigned long paths{0UL};
+    auto nodes = Common::build_nodes<21U, 21U>();
+    Memoized::calculate_paths(nodes[0], nodes, paths);
+    EXPECT_EQ(paths, 137846528820UL);
+
+    // From a node inside the grid: 3x2 nodes left to the bottom right corner
+    Memoized::calculate_paths(nodes[Common::Node<21U, 21U>::calculate_idx(18U, 19U)], nodes, paths);
+    EXPECT_EQ(paths, 3UL);
+
+    for (unsigned width = 1U; width < 8U; ++width)
+    {
+        for (unsigned height = 1U; height < 8U; ++height)
+        {
+            auto grid_nodes = Common::build_nodes(width, height);
+
+            unsigned long brute_paths{0UL};
+            Brute::calculate_paths(grid_nodes[0], grid_nodes, brute_paths);
+            Memoized::calculate_paths(grid_nodes[0], grid_nodes, paths);
+            EXPECT_EQ(paths, brute_paths);
+        }
+    }
+
+    // Deeper than the call stack would allow
+    auto long_nodes = Common::build_nodes(1000000U, 2U);
+    Memoized::calculate_paths(long_nodes[0], long_nodes, paths);
+    EXPECT_EQ(paths, 1000000UL);
+}
+
+TEST(Lattice_paths, test_better)
+{
+    unsigned long paths{0UL};
+    auto nodes = Common::build_nodes<21U, 21U>();
+    Better::calculate_paths(nodes, paths);
+    EXPECT_EQ(paths, 137846528820UL);
+
+    auto grid_nodes = Common::build_nodes(21U, 21U);
+    Better::calculate_paths(grid_nodes, paths);
+    EXPECT_EQ(paths, 137846528820UL);
+
+    grid_nodes = Common::build_nodes(4U, 3U);
+    Better::calculate_paths(grid_nodes, paths);
+    EXPECT_EQ(paths, 10UL);
+
+    grid_nodes = Common::build_nodes(1U, 1U);
+    Better::calculate_paths(grid_nodes, paths);
+    EXPECT_EQ(paths, 1UL);
+}
+
+TEST(Lattice_paths, test_better_row)
+{
+    unsigned long paths{0UL};
+    Better::calculate_paths(20U, 20U, paths);
+    EXPECT_EQ(paths, 137846528820UL);
+
+    Better::calculate_paths(3U, 2U, paths);
+    EXPECT_EQ(paths, 10UL);
+    Better::calculate_paths(2U, 3U, paths);
+    EXPECT_EQ(paths, 10UL);
+
+    Better::calculate_paths(0U, 5U, paths);
+    EXPECT_EQ(paths, 1UL);
+
+    // Same as nodes based, for all small grids
+    for (unsigned width = 1U; width < 10U; ++width)
+    {
+        for (unsigned height = 1U; height < 10U; ++height)
+        {
+            unsigned long node_paths{0UL};
+            auto nodes = Common::build_nodes(width + 1U, height + 1U);
+            Better::calculate_paths(nodes, node_paths);
+
+            Better::calculate_paths(width, height, paths);
+            EXPECT_EQ(paths, node_paths);
+        }
+    }
+}
+
+TEST(Lattice_paths, test_math)
+{
+    double paths{0};
+    Math::calculate_paths<20U, 20U>(paths);
+    EXPECT_DOUBLE_EQ(paths, 137846528820.0);
+
+    Math::calculate_paths(20U, 20U, paths);
+    EXPECT_DOUBLE_EQ(paths, 137846528820.0);
+
+    Math::calculate_paths(3U, 2U, paths);
+    EXPECT_DOUBLE_EQ(paths, 10.0);
+}
+
+TEST(Lattice_paths, test_big_number)
+{
+    Common::Big_number paths;
+    Better::calculate_paths(20U, 20U, paths);
+    EXPECT_EQ(paths.to_string(), "137846528820");
+
+    // Beyond unsigned long
+    Better::calculate_paths(50U, 50U, paths);
+    EXPECT_EQ(paths.to_string(), "100891344545564193334812497256");
+
+    Common::Big_number math_paths;
+    Math::calculate_paths(50U, 50U, math_paths);
+    EXPECT_EQ(math_paths, paths);
+
+    for (unsigned width = 0U; width < 70U; width += 7U)
+    {
+        for (unsigned height = 0U; height < 70U; height += 3U)
+        {
+            Better::calculate_paths(width, height, paths);
+            Math::calculate_paths(width, height, math_paths);
+            EXPECT_EQ(paths, math_paths);
+        }
+    }
+}
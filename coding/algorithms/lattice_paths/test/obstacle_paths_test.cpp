@@ -0,0 +1,99 @@
+#include <obstacle_paths.hpp>
+#include <lattice_paths.hpp>
+
+#include <gtest/gtest.h>
+
+#include <random>
+
+namespace
+{
+    Common::Obstacle_map random_obstacles(unsigned width, unsigned height, double density, unsigned seed)
+    {
+        std::mt19937 generator{seed};
+        std::bernoulli_distribution blocked{density};
+        Common::Obstacle_map obstacles{width, height};
+        for (unsigned y = 0U; y < height; ++y)
+        {
+            for (unsigned x = 0U; x < width; ++x)
+            {
+                if (blocked(generator))
+                {
+                    obstacles.block(x, y);
+                }
+            }
+        }
+        return obstacles;
+    }
+}
+
+TEST(Obstacle_paths, test_obstacle_map)
+{
+    Common::Obstacle_map obstacles{100U, 3U};
+    EXPECT_FALSE(obstacles.is_blocked(70U, 1U));
+
+    obstacles.block(70U, 1U);
+    EXPECT_TRUE(obstacles.is_blocked(70U, 1U));
+    EXPECT_FALSE(obstacles.is_blocked(70U, 0U));
+    EXPECT_FALSE(obstacles.is_blocked(6U, 1U));
+
+    obstacles.unblock(70U, 1U);
+    EXPECT_FALSE(obstacles.is_blocked(70U, 1U));
+}
+
+TEST(Obstacle_paths, test_no_obstacles)
+{
+    const Common::Obstacle_map obstacles{21U, 21U};
+
+    unsigned long paths{0UL};
+    Better::calculate_paths_sweep(obstacles, paths);
+    EXPECT_EQ(paths, 137846528820UL);
+
+    Better::calculate_paths_wavefront(obstacles, paths, 2U, 4U);
+    EXPECT_EQ(paths, 137846528820UL);
+}
+
+TEST(Obstacle_paths, test_obstacles)
+{
+    // 3x3 nodes, middle one blocked: only the paths along the edges are left
+    Common::Obstacle_map obstacles{3U, 3U};
+    obstacles.block(1U, 1U);
+
+    unsigned long paths{0UL};
+    Better::calculate_paths_sweep(obstacles, paths);
+    EXPECT_EQ(paths, 2UL);
+
+    // Wall with no gap
+    Common::Obstacle_map wall{4U, 4U};
+    for (unsigned x = 0U; x < 4U; ++x)
+    {
+        wall.block(x, 2U);
+    }
+    Better::calculate_paths_sweep(wall, paths);
+    EXPECT_EQ(paths, 0UL);
+
+    Common::Obstacle_map blocked_start{4U, 4U};
+    blocked_start.block(0U, 0U);
+    Better::calculate_paths_wavefront(blocked_start, paths, 2U, 2U);
+    EXPECT_EQ(paths, 0UL);
+}
+
+TEST(Obstacle_paths, test_wavefront)
+{
+    for (unsigned seed = 0U; seed < 5U; ++seed)
+    {
+        const auto obstacles = random_obstacles(53U + seed * 17U, 61U, 0.05, seed);
+
+        Common::Big_number paths;
+        Better::calculate_paths_sweep(obstacles, paths);
+
+        for (unsigned tile_size : {1U, 7U, 16U, 100U})
+        {
+            for (unsigned threads : {1U, 3U})
+            {
+                Common::Big_number wavefront_paths;
+                Better::calculate_paths_wavefront(obstacles, wavefront_paths, threads, tile_size);
+                EXPECT_EQ(wavefront_paths, paths);
+            }
+        }
+    }
+}
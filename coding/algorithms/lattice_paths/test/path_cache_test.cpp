@@ -0,0 +1,58 @@
+#include <path_cache.hpp>
+#include <lattice_paths.hpp>
+
+#include <gtest/gtest.h>
+
+TEST(Path_cache, test_paths)
+{
+    Math::Path_cache cache;
+
+    EXPECT_EQ(cache.paths(2U, 2U), 6UL);
+    EXPECT_EQ(cache.paths(20U, 20U), 137846528820UL);
+    EXPECT_EQ(cache.paths(3U, 2U), 10UL);
+    EXPECT_EQ(cache.paths(0U, 0U), 1UL);
+    EXPECT_EQ(cache.paths(34U, 33U), 14226520737620288370UL);
+    EXPECT_THROW(cache.paths(34U, 34U), std::out_of_range);
+
+    for (unsigned width = 0U; width <= 33U; ++width)
+    {
+        for (unsigned height = 0U; height <= 33U; ++height)
+        {
+            unsigned long paths{0UL};
+            Better::calculate_paths(width, height, paths);
+            EXPECT_EQ(cache.paths(width, height), paths);
+        }
+    }
+}
+
+TEST(Path_cache, test_paths_batch)
+{
+    Math::Path_cache cache;
+    std::vector<unsigned long> results;
+
+    cache.paths({{2U, 2U}, {20U, 20U}, {1U, 0U}}, results);
+    EXPECT_EQ(results, (std::vector<unsigned long>{6UL, 137846528820UL, 1UL}));
+
+    cache.paths({}, results);
+    EXPECT_TRUE(results.empty());
+}
+
+TEST(Path_cache, test_paths_mod)
+{
+    Math::Path_cache cache;
+    const Math::Binomial binomial{4000U};
+
+    // Caches grow between queries
+    EXPECT_EQ(cache.paths_mod(20U, 20U), 137846528820UL % cache.modulus());
+    for (unsigned size : {10U, 100U, 1000U, 2000U})
+    {
+        auto exact = binomial(2U * size, size);
+        EXPECT_EQ(cache.paths_mod(size, size), exact.divide(cache.modulus()));
+    }
+
+    std::vector<uint32_t> results;
+    cache.paths_mod({{20U, 20U}, {1000U, 1000U}}, results);
+    ASSERT_EQ(results.size(), 2U);
+    EXPECT_EQ(results[0], cache.paths_mod(20U, 20U));
+    EXPECT_EQ(results[1], cache.paths_mod(1000U, 1000U));
+}
@@ -0,0 +1,52 @@
+#include <path_table.hpp>
+#include <lattice_paths.hpp>
+
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+#include <string>
+
+namespace
+{
+    std::string to_string(Math::uint128_t number)
+    {
+        std::string digits;
+        do
+        {
+            digits.insert(digits.begin(), static_cast<char>('0' + static_cast<unsigned>(number % 10U)));
+            number /= 10U;
+        } while (number != 0U);
+        return digits;
+    }
+}
+
+TEST(Path_table, test_compile_time)
+{
+    static_assert(Math::path_count<0U, 0U>::m_value == 1U);
+    static_assert(Math::path_count<2U, 2U>::m_value == 6U);
+    static_assert(Math::path_count<20U, 20U>::m_value == 137846528820U);
+    static_assert(Math::table_paths(3U, 5U) == 56U);
+    static_assert(Math::table_paths(5U, 3U) == 56U);
+
+    EXPECT_EQ(to_string(Math::path_count<65U, 66U>::m_value), "188694833082770476622296176145946360850");
+    EXPECT_EQ(to_string(Math::table_paths(131U, 0U)), "1");
+}
+
+TEST(Path_table, test_matches_exact)
+{
+    for (unsigned width = 0U; width <= Math::MAX_TABLE_N; ++width)
+    {
+        for (unsigned height = 0U; width + height <= Math::MAX_TABLE_N; ++height)
+        {
+            Common::Big_number expected;
+            Math::calculate_paths(width, height, expected);
+            EXPECT_EQ(to_string(Math::table_paths(width, height)), expected.to_string());
+        }
+    }
+}
+
+TEST(Path_table, test_out_of_range)
+{
+    EXPECT_THROW(Math::table_paths(66U, 66U), std::out_of_range);
+    EXPECT_THROW(Math::table_paths(0U, 132U), std::out_of_range);
+}
@@ -0,0 +1,65 @@
+#include <row_sweep.hpp>
+#include <lattice_paths.hpp>
+
+#include <gtest/gtest.h>
+
+#include <random>
+#include <vector>
+
+namespace
+{
+    template <typename Count>
+    void expect_same_as_scalar()
+    {
+        std::mt19937_64 generator{7U};
+        for (size_t size = 0U; size < 40U; ++size)
+        {
+            std::vector<Count> row(size);
+            for (auto &count : row)
+            {
+                count = static_cast<Count>(generator());
+            }
+
+            auto expected = row;
+            Better::detail::sweep_row_scalar(expected.data(), expected.size());
+
+            auto dispatched = row;
+            Better::sweep_row(dispatched.data(), dispatched.size());
+            EXPECT_EQ(dispatched, expected);
+
+#ifdef LATTICE_PATHS_X86
+            if (Better::detail::has_avx2())
+            {
+                Better::detail::sweep_row_avx2(row.data(), row.size());
+                EXPECT_EQ(row, expected);
+            }
+#endif
+        }
+    }
+}
+
+TEST(Row_sweep, test_sweep_row)
+{
+    std::vector<uint64_t> row{1U, 2U, 3U, 4U, 5U, 6U};
+    Better::sweep_row(row.data(), row.size());
+    EXPECT_EQ(row, (std::vector<uint64_t>{1U, 3U, 6U, 10U, 15U, 21U}));
+}
+
+TEST(Row_sweep, test_same_as_scalar)
+{
+    expect_same_as_scalar<uint32_t>();
+    expect_same_as_scalar<uint64_t>();
+}
+
+TEST(Row_sweep, test_calculate_paths_32bit)
+{
+    uint32_t paths{0U};
+    Better::calculate_paths(10U, 10U, paths);
+    EXPECT_EQ(paths, 184756U);
+
+    unsigned long paths64{0UL};
+    Better::calculate_paths(33U, 31U, paths64);
+    Common::Big_number exact;
+    Math::calculate_paths(33U, 31U, exact);
+    EXPECT_EQ(Common::Big_number{paths64}, exact);
+}
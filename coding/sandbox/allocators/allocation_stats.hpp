@@ -0,0 +1,385 @@
+// Copyright (c) 2024, Piotr Staniszewski
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Statistics policies of allocators, chosen at compile time. Every policy has
+//  - on_allocate(ptr, bytes) and on_deallocate(ptr, bytes), called by the allocator,
+//  - report(stream), called on demand.
+// Copies of a policy (made when an allocator is copied or rebound) report to the same place.
+namespace stats
+{
+
+    // Nothing is recorded, the calls compile to nothing
+    struct No_stats
+    {
+        void on_allocate(const void *, std::size_t) noexcept
+        {
+        }
+
+        void on_deallocate(const void *, std::size_t) noexcept
+        {
+        }
+
+        void report(std::ostream &stream) const
+        {
+            stream << "No statistics\n";
+        }
+    };
+
+    // Counters updated with relaxed atomic increments
+    class Atomic_counters
+    {
+    public:
+        Atomic_counters() = default;
+
+        // No move: a moved-from policy (left in a moved-from container) still reports to the same counters
+        Atomic_counters(const Atomic_counters &) = default;
+        Atomic_counters &operator=(const Atomic_counters &) = default;
+
+        void on_allocate(const void *, std::size_t bytes) noexcept
+        {
+            m_counters->m_allocations.fetch_add(1U, std::memory_order_relaxed);
+            m_counters->m_allocated_bytes.fetch_add(bytes, std::memory_order_relaxed);
+        }
+
+        void on_deallocate(const void *, std::size_t bytes) noexcept
+        {
+            m_counters->m_deallocations.fetch_add(1U, std::memory_order_relaxed);
+            m_counters->m_deallocated_bytes.fetch_add(bytes, std::memory_order_relaxed);
+        }
+
+        std::size_t allocations() const noexcept { return m_counters->m_allocations.load(std::memory_order_relaxed); }
+        std::size_t deallocations() const noexcept { return m_counters->m_deallocations.load(std::memory_order_relaxed); }
+        std::size_t allocated_bytes() const noexcept { return m_counters->m_allocated_bytes.load(std::memory_order_relaxed); }
+        std::size_t deallocated_bytes() const noexcept { return m_counters->m_deallocated_bytes.load(std::memory_order_relaxed); }
+
+        void report(std::ostream &stream) const
+        {
+            stream << "Allocations: " << allocations() << ", bytes: " << allocated_bytes() << "\n";
+            stream << "Deallocations: " << deallocations() << ", bytes: " << deallocated_bytes() << "\n";
+        }
+
+    private:
+        struct Counters
+        {
+            std::atomic<std::size_t> m_allocations{0U};
+            std::atomic<std::size_t> m_deallocations{0U};
+            std::atomic<std::size_t> m_allocated_bytes{0U};
+            std::atomic<std::size_t> m_deallocated_bytes{0U};
+        };
+
+        std::shared_ptr<Counters> m_counters{std::make_shared<Counters>()};
+    };
+
+    /**
+     * @brief Every call recorded into a lock-free ring buffer, last CAPACITY of them are kept.
+     *
+     * A writer claims a slot with one atomic increment. Each slot has a sequence number, zeroed while
+     * the slot is written and set to claimed index + 1 after, so report() skips slots being written
+     * (or overwritten) instead of printing torn events.
+     *
+     * @tparam CAPACITY Number of events kept.
+     */
+    template <std::size_t CAPACITY = 4096>
+    class Tracing
+    {
+    public:
+        enum class Operation : std::uint8_t
+        {
+            ALLOCATE,
+            DEALLOCATE
+        };
+
+        Tracing() = default;
+
+        // No move: a moved-from policy (left in a moved-from container) still records to the same ring
+        Tracing(const Tracing &) = default;
+        Tracing &operator=(const Tracing &) = default;
+
+        void on_allocate(const void *ptr, std::size_t bytes) noexcept
+        {
+            record(Operation::ALLOCATE, ptr, bytes);
+        }
+
+        void on_deallocate(const void *ptr, std::size_t bytes) noexcept
+        {
+            record(Operation::DEALLOCATE, ptr, bytes);
+        }
+
+        // Events recorded so far, including overwritten ones
+        std::size_t events() const noexcept
+        {
+            return m_ring->m_next.load(std::memory_order_acquire);
+        }
+
+        void report(std::ostream &stream) const
+        {
+            const std::size_t end = events();
+            const std::size_t begin = end > CAPACITY ? end - CAPACITY : 0U;
+            for (std::size_t index = begin; index < end; ++index)
+            {
+                const auto &slot = m_ring->m_slots[index % CAPACITY];
+                if (slot.m_sequence.load(std::memory_order_acquire) != index + 1U)
+                {
+                    continue;
+                }
+                const auto operation = slot.m_operation.load(std::memory_order_relaxed);
+                const auto *ptr = slot.m_ptr.load(std::memory_order_relaxed);
+                const auto bytes = slot.m_bytes.load(std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (slot.m_sequence.load(std::memory_order_relaxed) != index + 1U)
+                {
+                    continue;
+                }
+
+                stream << "#" << index << (operation == Operation::ALLOCATE ? " allocate " : " deallocate ") << bytes << " bytes at " << ptr << "\n";
+            }
+        }
+
+    private:
+        struct Slot
+        {
+            std::atomic<std::size_t> m_sequence{0U};
+            std::atomic<Operation> m_operation{Operation::ALLOCATE};
+            std::atomic<const void *> m_ptr{nullptr};
+            std::atomic<std::size_t> m_bytes{0U};
+        };
+
+        struct Ring
+        {
+            std::atomic<std::size_t> m_next{0U};
+            std::array<Slot, CAPACITY> m_slots;
+        };
+
+        void record(Operation operation, const void *ptr, std::size_t bytes) noexcept
+        {
+            const std::size_t index = m_ring->m_next.fetch_add(1U, std::memory_order_relaxed);
+            auto &slot = m_ring->m_slots[index % CAPACITY];
+
+            slot.m_sequence.store(0U, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            slot.m_operation.store(operation, std::memory_order_relaxed);
+            slot.m_ptr.store(ptr, std::memory_order_relaxed);
+            slot.m_bytes.store(bytes, std::memory_order_relaxed);
+            slot.m_sequence.store(index + 1U, std::memory_order_release);
+        }
+
+        std::shared_ptr<Ring> m_ring{std::make_shared<Ring>()};
+    };
+
+    /**
+     * @brief Allocation site tag: allocations made while a Tag_scope of it is active are counted by it.
+     *
+     * Tags live as long as the program (static objects), they register themselves in the profile.
+     */
+    class Tag
+    {
+    public:
+        explicit Tag(std::string name);
+
+        Tag(const Tag &) = delete;
+        Tag &operator=(const Tag &) = delete;
+
+        const std::string &name() const noexcept { return m_name; }
+        std::size_t allocations() const noexcept { return m_allocations.load(std::memory_order_relaxed); }
+        std::size_t bytes() const noexcept { return m_bytes.load(std::memory_order_relaxed); }
+
+        void record(std::size_t bytes) noexcept
+        {
+            m_allocations.fetch_add(1U, std::memory_order_relaxed);
+            m_bytes.fetch_add(bytes, std::memory_order_relaxed);
+        }
+
+    private:
+        std::string m_name;
+        std::atomic<std::size_t> m_allocations{0U};
+        std::atomic<std::size_t> m_bytes{0U};
+    };
+
+    /**
+     * @brief Process-wide allocation profile, fed by every allocator using the Profiling policy.
+     *
+     * Live and peak bytes, counts by 16-byte size class (up to 256 bytes, same as the pools),
+     * histogram of sizes by powers of two and totals per tag. Updates are relaxed atomics, readable any time.
+     */
+    class Profile
+    {
+    public:
+        static constexpr std::size_t SIZE_CLASS_GRANULARITY = 16U;
+        static constexpr std::size_t SIZE_CLASSES = 16U;
+        static constexpr std::size_t HISTOGRAM_BUCKETS = 64U;
+
+        static Profile &instance()
+        {
+            // Never destroyed: containers with static storage duration are freed after static destructors have run
+            static Profile &profile = *new Profile;
+            return profile;
+        }
+
+        Profile(const Profile &) = delete;
+        Profile &operator=(const Profile &) = delete;
+
+        void on_allocate(std::size_t bytes) noexcept
+        {
+            m_allocations.fetch_add(1U, std::memory_order_relaxed);
+            const std::size_t live = m_live_bytes.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+            std::size_t peak = m_peak_bytes.load(std::memory_order_relaxed);
+            while (live > peak && !m_peak_bytes.compare_exchange_weak(peak, live, std::memory_order_relaxed))
+            {
+            }
+
+            if (bytes != 0U && bytes <= SIZE_CLASSES * SIZE_CLASS_GRANULARITY)
+            {
+                m_size_classes[(bytes - 1U) / SIZE_CLASS_GRANULARITY].fetch_add(1U, std::memory_order_relaxed);
+            }
+            m_histogram[histogram_bucket(bytes)].fetch_add(1U, std::memory_order_relaxed);
+
+            if (Tag *tag = current_tag())
+            {
+                tag->record(bytes);
+            }
+        }
+
+        void on_deallocate(std::size_t bytes) noexcept
+        {
+            m_deallocations.fetch_add(1U, std::memory_order_relaxed);
+            m_live_bytes.fetch_sub(bytes, std::memory_order_relaxed);
+        }
+
+        std::size_t allocations() const noexcept { return m_allocations.load(std::memory_order_relaxed); }
+        std::size_t deallocations() const noexcept { return m_deallocations.load(std::memory_order_relaxed); }
+        std::size_t live_bytes() const noexcept { return m_live_bytes.load(std::memory_order_relaxed); }
+        std::size_t peak_bytes() const noexcept { return m_peak_bytes.load(std::memory_order_relaxed); }
+
+        // Allocations of 1..16 bytes in class 0, 17..32 in class 1 and so on
+        std::size_t size_class_count(std::size_t size_class) const noexcept
+        {
+            return m_size_classes[size_class].load(std::memory_order_relaxed);
+        }
+
+        // Bucket b counts sizes in [2^(b-1), 2^b), bucket 0 the empty allocations
+        static std::size_t histogram_bucket(std::size_t bytes) noexcept
+        {
+            return std::bit_width(bytes);
+        }
+
+        std::size_t histogram_count(std::size_t bucket) const noexcept
+        {
+            return m_histogram[bucket].load(std::memory_order_relaxed);
+        }
+
+        // Allocations of the calling thread are counted by the tag of the innermost Tag_scope
+        static Tag *&current_tag() noexcept
+        {
+            thread_local Tag *tag{nullptr};
+            return tag;
+        }
+
+        void register_tag(Tag &tag)
+        {
+            std::lock_guard lock{m_tags_mutex};
+            m_tags.push_back(&tag);
+        }
+
+        std::vector<const Tag *> tags() const
+        {
+            std::lock_guard lock{m_tags_mutex};
+            return {m_tags.begin(), m_tags.end()};
+        }
+
+        void report(std::ostream &stream) const
+        {
+            stream << "Allocations: " << allocations() << ", deallocations: " << deallocations() << "\n";
+            stream << "Live bytes: " << live_bytes() << ", peak: " << peak_bytes() << "\n";
+            stream << "Size classes:";
+            for (std::size_t size_class = 0U; size_class < SIZE_CLASSES; ++size_class)
+            {
+                stream << " " << (size_class + 1U) * SIZE_CLASS_GRANULARITY << ":" << size_class_count(size_class);
+            }
+            stream << "\nHistogram:";
+            for (std::size_t bucket = 0U; bucket < HISTOGRAM_BUCKETS; ++bucket)
+            {
+                if (histogram_count(bucket) != 0U)
+                {
+                    stream << " <" << (std::size_t{1U} << bucket) << ":" << histogram_count(bucket);
+                }
+            }
+            stream << "\n";
+            for (const Tag *tag : tags())
+            {
+                stream << "Tag " << tag->name() << ": " << tag->allocations() << " allocations, " << tag->bytes() << " bytes\n";
+            }
+        }
+
+    private:
+        Profile() = default;
+
+        std::atomic<std::size_t> m_allocations{0U};
+        std::atomic<std::size_t> m_deallocations{0U};
+        std::atomic<std::size_t> m_live_bytes{0U};
+        std::atomic<std::size_t> m_peak_bytes{0U};
+        std::array<std::atomic<std::size_t>, SIZE_CLASSES> m_size_classes{};
+        std::array<std::atomic<std::size_t>, HISTOGRAM_BUCKETS> m_histogram{};
+
+        mutable std::mutex m_tags_mutex;
+        std::vector<Tag *> m_tags;
+    };
+
+    inline Tag::Tag(std::string name) : m_name{std::move(name)}
+    {
+        Profile::instance().register_tag(*this);
+    }
+
+    // Tags allocations of the calling thread until the end of the scope, scopes nest
+    class Tag_scope
+    {
+    public:
+        explicit Tag_scope(Tag &tag) noexcept : m_previous{Profile::current_tag()}
+        {
+            Profile::current_tag() = &tag;
+        }
+
+        Tag_scope(const Tag_scope &) = delete;
+        Tag_scope &operator=(const Tag_scope &) = delete;
+
+        ~Tag_scope() noexcept
+        {
+            Profile::current_tag() = m_previous;
+        }
+
+    private:
+        Tag *m_previous;
+    };
+
+    // Everything goes to the process-wide profile, so all copies and rebinds share it by construction
+    struct Profiling
+    {
+        void on_allocate(const void *, std::size_t bytes) noexcept
+        {
+            Profile::instance().on_allocate(bytes);
+        }
+
+        void on_deallocate(const void *, std::size_t bytes) noexcept
+        {
+            Profile::instance().on_deallocate(bytes);
+        }
+
+        void report(std::ostream &stream) const
+        {
+            Profile::instance().report(stream);
+        }
+    };
+
+}
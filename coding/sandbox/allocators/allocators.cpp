@@ -1,316 +1,169 @@
 // Copyright (c) 2024, Piotr Staniszewski
 
+#include "allocators.hpp"
+#include "boundary_tag_allocator.hpp"
+#include "buddy_allocator.hpp"
+#include "mapped_memory.hpp"
+#include "pool_allocator.hpp"
+#include "shared_arena_allocator.hpp"
+
+#include <functional>
 #include <iostream>
-#include <limits>
+#include <list>
+#include <map>
+#include <memory>
+#include <memory_resource>
 #include <vector>
-#include <set>
-#include <algorithm>
 
-namespace simple
+int main()
 {
+    std::cout << "allocators\n";
 
-    /**
-     * @brief A custom allocator that counts the number of allocated objects.
-     *
-     * This allocator provides the basic functionality to allocate and deallocate memory
-     * for objects of type T. It also keeps track of the total number of allocated objects.
-     *
-     * @tparam T The type of the elements to allocate memory for.
-     */
-    template <typename T>
-    class Counting_allocator
+    std::vector<int, simple::Counting_allocator<int, stats::Tracing<>>> vec1;
+    for (int i = 0; i < 10; ++i)
     {
-    public:
-        using value_type = T;
-        using size_type = std::size_t;
-        using difference_type = std::ptrdiff_t;
-
-        Counting_allocator() noexcept : m_allocated_objs{0}
-        {
-            std::cout << "Counting_allocator ctor\n";
-        }
-
-        template <typename U>
-        Counting_allocator(const Counting_allocator<U> &other) noexcept : m_allocated_objs{other.m_allocated_objs}
-        {
-            std::cout << "Counting_allocator copy ctor\n";
-        }
-
-        ~Counting_allocator() noexcept
-        {
-            std::cout << "Counting_allocator dtor\n";
-        }
-
-        [[nodiscard]] constexpr T *allocate(size_type n)
-        {
-            std::cout << "Allocate memory for " << n << " element(s)\n";
-            if (n > std::numeric_limits<size_type>::max() / sizeof(T))
-            {
-                throw std::bad_alloc();
-            }
-            T *ptr = static_cast<T *>(::operator new(n * sizeof(T)));
-            if (!ptr)
-            {
-                throw std::bad_alloc();
-            }
-
-            m_allocated_objs += n;
-            std::cout << "Memory allocated: " << sizeof(T) * m_allocated_objs << "\n";
-
-            return ptr;
-        }
-
-        constexpr void deallocate(T *ptr, size_type) noexcept
-        {
-            std::cout << "Deallocate memory\n";
-            ::operator delete(ptr);
-
-            m_allocated_objs = 0;
-            std::cout << "Memory allocated: " << sizeof(T) * m_allocated_objs << "\n";
-        }
-
-    private:
-        size_type m_allocated_objs;
-    };
-
-}
-
-namespace medium
-{
+        vec1.push_back(i);
+    }
+    vec1.get_allocator().stats().report(std::cout);
+    std::cout << "Allocated: " << vec1.get_allocator().allocated_bytes() << " bytes\n";
+    const simple::Counting_allocator<long, stats::Tracing<>> rebound_counting{vec1.get_allocator()};
+    std::cout << "Rebound counting allocator equal: " << std::boolalpha << (rebound_counting == vec1.get_allocator()) << "\n";
 
-    /**
-     * @brief Custom allocator that allocates memory from a fixed-size area.
-     *
-     * This allocator provides a fixed-size memory area from which memory is allocated and deallocated.
-     * It ensures that the allocated memory does not exceed a predefined maximum size.
-     *
-     * @tparam T The type of elements to allocate memory for.
-     */
-    template <typename T>
-    class Overwritting_allocator
+    static stats::Tag squares_tag{"squares"};
     {
-    public:
-        using value_type = T;
-        using size_type = std::size_t;
-        using difference_type = std::ptrdiff_t;
+        stats::Tag_scope scope{squares_tag};
 
-        static constexpr const size_type MAX = 1024;
-
-        Overwritting_allocator() noexcept
-        {
-            std::cout << "Overwritting_allocator ctor\n";
-        }
-
-        template <typename U>
-        Overwritting_allocator(const Overwritting_allocator<U> &other) noexcept
+        std::map<int, int, std::less<int>, simple::Counting_allocator<std::pair<const int, int>, stats::Profiling>> squares;
+        for (int i = 0; i < 10; ++i)
         {
-            std::cout << "Overwritting_allocator copy ctor\n";
+            squares.emplace(i, i * i);
         }
+        std::vector<int, simple::Counting_allocator<int, stats::Profiling>> buffer(100);
+        stats::Profile::instance().report(std::cout);
+    }
 
-        ~Overwritting_allocator() noexcept
+    medium::Monotonic_arena arena;
+    {
+        std::vector<int, medium::Arena_allocator<int>> vec2{medium::Arena_allocator<int>{arena}};
+        for (int i = 10; i < 20; ++i)
         {
-            std::cout << "Overwritting_allocator dtor\n";
+            vec2.push_back(i);
         }
 
-        [[nodiscard]] constexpr T *allocate(size_type n)
+        std::pmr::vector<int> pmr_vec2{&arena};
+        for (auto item : vec2)
         {
-            std::cout << "Allocate memory for " << n << " element(s)\n";
-            if (n > MAX)
-            {
-                throw std::bad_alloc();
-            }
-            T *ptr = &m_fixed_memory_area[0];
-
-            std::cout << "Memory allocated at: " << std::hex << &m_fixed_memory_area[0] << std::dec << "\n";
-
-            return ptr;
+            pmr_vec2.push_back(item);
         }
 
-        constexpr void deallocate(T *, size_type) noexcept
+        for (auto item : pmr_vec2)
         {
-            std::cout << "Deallocate memory\n";
-
-            std::cout << "Memory deallocated at: " << std::hex << &m_fixed_memory_area[0] << std::dec << "\n";
+            std::cout << item << ", ";
         }
 
-    private:
-        T m_fixed_memory_area[MAX];
-    };
-
-}
+        std::cout << "\n";
 
-namespace complex
-{
+        const medium::Arena_allocator<long> rebound{vec2.get_allocator()};
+        std::cout << "Rebound allocator equal: " << std::boolalpha << (rebound == vec2.get_allocator()) << "\n";
+    }
+    std::cout << "Arena capacity: " << arena.capacity() << " bytes\n";
+    arena.reset();
 
-    template <typename T>
-    class Safe_allocator
+    std::vector<int, complex::Safe_allocator<int, 1024, stats::Atomic_counters>> vec3;
+    for (int i = 20; i < 30; ++i)
     {
-    public:
-        using value_type = T;
-        using size_type = std::size_t;
-        using difference_type = std::ptrdiff_t;
-
-        static constexpr const size_type MAX = 1024;
-
-        Safe_allocator() noexcept : m_allocated_sections{}, m_free_sections{{&m_memory[0], MAX}}
-        {
-            std::cout << "Safe_allocator ctor\n";
-
-            show_stats();
-        }
-
-        template <typename U>
-        Safe_allocator(const Safe_allocator<U> &other) noexcept : m_allocated_sections{other.m_allocated_sections}, m_free_sections{other.m_free_sections}
-        {
-            std::cout << "Safe_allocator copy ctor\n";
-
-            show_stats();
-        }
-
-        ~Safe_allocator() noexcept
-        {
-            std::cout << "Safe_allocator dtor\n";
-
-            show_stats();
-        }
-
-        [[nodiscard]] constexpr T *allocate(size_type n)
-        {
-            std::cout << "Allocate memory for " << n << " element(s)\n";
-
-            if (m_free_sections.empty())
-            {
-                throw std::bad_alloc();
-            }
+        vec3.push_back(i);
+    }
+    vec3.get_allocator().stats().report(std::cout);
 
-            // TODO: find best matching section (of exact requested size)
-            auto size_equal_or_more = [&n](const Section &s)
-            { return (n <= s.m_length); };
-            auto it = std::find_if(std::begin(m_free_sections), std::end(m_free_sections), size_equal_or_more);
-            if (it == std::end(m_free_sections))
-            {
-                throw std::bad_alloc();
-            }
+    complex::Boundary_tag_arena<4096U> tag_arena;
+    std::vector<int, complex::Boundary_tag_allocator<int>> vec4{complex::Boundary_tag_allocator<int>{tag_arena}};
+    for (int i = 30; i < 40; ++i)
+    {
+        vec4.push_back(i);
+    }
 
-            auto &free_section = *it;
+    for (auto item : vec4)
+    {
+        std::cout << item << ", ";
+    }
 
-            auto allocated_section = Section(free_section.m_begin, n);
-            m_allocated_sections.insert(allocated_section);
+    std::cout << "\n";
 
-            auto new_free_section = Section(free_section.m_begin + n, free_section.m_length - n);
-            m_free_sections.erase(it);
+    complex::Buddy_arena<4096U> buddy_arena;
+    std::vector<int, complex::Buddy_allocator<int>> vec7{complex::Buddy_allocator<int>{buddy_arena}};
+    for (int i = 35; i < 40; ++i)
+    {
+        vec7.push_back(i);
+    }
+    std::cout << "Buddy largest free block: " << buddy_arena.largest_free_block() << " bytes\n";
 
-            if (new_free_section.m_length > 0U)
-            {
-                m_free_sections.insert(new_free_section);
-            }
+    std::map<int, int, std::less<int>, medium::Pool_allocator<std::pair<const int, int>>> map1;
+    for (int i = 40; i < 50; ++i)
+    {
+        map1.emplace(i, i * i);
+    }
 
-            show_stats();
+    for (const auto &[key, value] : map1)
+    {
+        std::cout << key << ": " << value << ", ";
+    }
 
-            return allocated_section.m_begin;
-        }
+    std::cout << "\n";
 
-        constexpr void deallocate(T *ptr, size_type n) noexcept
+    using Arena = complex::Boundary_tag_arena<64U * 1024U>;
+    using List = std::list<int, complex::Shared_arena_allocator<int, Arena>>;
+    auto arena1 = std::make_unique<Arena>();
+    auto arena2 = std::make_unique<Arena>();
+    {
+        List list1{List::allocator_type{*arena1}};
+        for (int i = 50; i < 60; ++i)
         {
-            std::cout << "Deallocate memory\n";
-
-            auto section_found = [ptr, &n](const Section &s)
-            { return (ptr == s.m_begin && n == s.m_length); };
-            auto it = std::find_if(std::begin(m_allocated_sections), std::end(m_allocated_sections), section_found);
-            if (it == std::end(m_allocated_sections))
-            {
-                std::cerr << "Invalid deallocation requested?\n";
-            }
-
-            m_free_sections.insert(*it);
-            m_allocated_sections.erase(it);
-
-            // TODO: merge free neighbouring sections
-
-            show_stats();
+            list1.push_back(i);
         }
 
-    private:
-        struct Section
-        {
-            Section(T *begin, size_type n) : m_begin{begin}, m_length{n} {}
-
-            T *m_begin;
-            size_type m_length;
-        };
+        // Nodes stay in the first arena, the allocator comes along
+        List list2{List::allocator_type{*arena2}};
+        list2 = std::move(list1);
+        std::cout << "Moved list in first arena: " << std::boolalpha << (&list2.get_allocator().arena() == arena1.get()) << "\n";
+        const complex::Shared_arena_allocator<long, Arena> rebound_shared{list2.get_allocator()};
+        std::cout << "Rebound shared arena allocator equal: " << (rebound_shared == list2.get_allocator()) << "\n";
 
-        friend bool operator<(const Section &lhs, const Section &rhs)
+        for (auto item : list2)
         {
-            return lhs.m_begin < rhs.m_begin;
+            std::cout << item << ", ";
         }
 
-        friend bool operator==(const Section &lhs, const Section &rhs)
-        {
-            return lhs.m_begin == rhs.m_begin;
-        }
+        std::cout << "\n";
+    }
 
-        template <typename Container>
-        size_type size_in_bytes(const Container &sections) const
+    // Big arenas straight from the kernel, on huge pages of the local NUMA node when the system allows
+    backing::Mapped_resource mapped{backing::Options{backing::Huge_pages::EXPLICIT, true}};
+    {
+        medium::Monotonic_arena mapped_arena{4U * 1024U * 1024U, &mapped};
+        std::pmr::vector<int> vec5{&mapped_arena};
+        for (int i = 60; i < 70; ++i)
         {
-            size_type bytes{};
-            for (auto section : sections)
-            {
-                bytes += sizeof(T) * section.m_length;
-            }
-
-            return bytes;
+            vec5.push_back(i);
         }
 
-        void show_stats() const
+        for (auto item : vec5)
         {
-            std::cout << "Allocated sections: " << m_allocated_sections.size() << ", bytes: " << size_in_bytes(m_allocated_sections) << "\n";
-
-            for (const auto &section : m_allocated_sections)
-            {
-                std::cout << "\tSection at " << static_cast<const int*>(section.m_begin) << ", bytes: " << sizeof(T) * section.m_length << "\n";
-            }
-            std::cout << "Free sections: " << m_free_sections.size() << ", bytes: " << size_in_bytes(m_free_sections) << "\n";
-            for (const auto &section : m_free_sections)
-            {
-                std::cout << "\tSection at " << static_cast<const int*>(section.m_begin) << ", bytes: " << sizeof(T) * section.m_length << "\n";
-            }
+            std::cout << item << ", ";
         }
 
-        T m_memory[MAX];
-
-        std::set<Section> m_allocated_sections;
-        std::set<Section> m_free_sections;
-    };
-
-}
-
-int main()
-{
-    std::cout << "allocators\n";
-
-    std::vector<int, simple::Counting_allocator<int>> vec1;
-    for (int i = 0; i < 10; ++i)
-    {
-        vec1.push_back(i);
+        std::cout << "\n";
     }
 
-    std::vector<int, medium::Overwritting_allocator<int>> vec2;
-    for (int i = 10; i < 20; ++i)
+    using Big_arena = complex::Boundary_tag_arena<1024U * 1024U>;
+    backing::Mapped_object<Big_arena> mapped_tag_arena{backing::Options{}};
+    std::cout << "Mapped " << mapped_tag_arena.memory().size() << " bytes, explicit huge pages: " << mapped_tag_arena.memory().explicit_huge_pages()
+              << ", transparent huge pages: " << mapped_tag_arena.memory().transparent_huge_pages() << ", NUMA node: " << mapped_tag_arena.memory().numa_node() << "\n";
     {
-        vec2.push_back(i);
-    }
-
-    for (auto item : vec2)
-    {
-        std::cout << item << ", ";
-    }
-
-    std::cout << "\n";
-
-    std::vector<int, complex::Safe_allocator<int>> vec3;
-    for (int i = 20; i < 30; ++i)
-    {
-        vec3.push_back(i);
+        using Big_allocator = complex::Shared_arena_allocator<int, Big_arena>;
+        std::vector<int, Big_allocator> vec6{Big_allocator{*mapped_tag_arena}};
+        vec6.assign(10, 70);
+        std::cout << "Largest free block: " << mapped_tag_arena->largest_free_block() << " bytes\n";
     }
 
     return EXIT_SUCCESS;
@@ -0,0 +1,504 @@
+// Copyright (c) 2024, Piotr Staniszewski
+
+#pragma once
+
+#include "allocation_stats.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <memory_resource>
+#include <set>
+#include <type_traits>
+#include <utility>
+
+namespace simple
+{
+
+    /**
+     * @brief A custom allocator that counts the memory allocated through it.
+     *
+     * This allocator provides the basic functionality to allocate and deallocate memory
+     * for objects of type T. It also keeps track of bytes currently allocated, in a counter
+     * shared by all its copies and rebinds (containers allocate through rebound copies).
+     *
+     * @tparam T The type of the elements to allocate memory for.
+     * @tparam Stats Statistics policy (see allocation_stats.hpp).
+     */
+    template <typename T, typename Stats = stats::No_stats>
+    class Counting_allocator
+    {
+    public:
+        using value_type = T;
+        using size_type = std::size_t;
+        using difference_type = std::ptrdiff_t;
+
+        Counting_allocator() : m_allocated_bytes{std::make_shared<std::atomic<size_type>>(0U)}
+        {
+        }
+
+        // No move: containers keep using the moved-from allocator, it has to share the counter still
+        Counting_allocator(const Counting_allocator &) = default;
+        Counting_allocator &operator=(const Counting_allocator &) = default;
+
+        template <typename U>
+        Counting_allocator(const Counting_allocator<U, Stats> &other) noexcept : m_allocated_bytes{other.m_allocated_bytes}, m_stats{other.m_stats}
+        {
+        }
+
+        [[nodiscard]] constexpr T *allocate(size_type n)
+        {
+            if (n > std::numeric_limits<size_type>::max() / sizeof(T))
+            {
+                throw std::bad_alloc();
+            }
+            T *ptr = static_cast<T *>(::operator new(n * sizeof(T)));
+            if (!ptr)
+            {
+                throw std::bad_alloc();
+            }
+
+            m_allocated_bytes->fetch_add(n * sizeof(T), std::memory_order_relaxed);
+            m_stats.on_allocate(ptr, n * sizeof(T));
+
+            return ptr;
+        }
+
+        constexpr void deallocate(T *ptr, size_type n) noexcept
+        {
+            m_stats.on_deallocate(ptr, n * sizeof(T));
+            ::operator delete(ptr);
+
+            m_allocated_bytes->fetch_sub(n * sizeof(T), std::memory_order_relaxed);
+        }
+
+        size_type allocated_bytes() const noexcept
+        {
+            return m_allocated_bytes->load(std::memory_order_relaxed);
+        }
+
+        const Stats &stats() const noexcept
+        {
+            return m_stats;
+        }
+
+        // Counter shared by copies and rebinds
+        const std::atomic<size_type> &counter() const noexcept
+        {
+            return *m_allocated_bytes;
+        }
+
+    private:
+        template <typename U, typename>
+        friend class Counting_allocator;
+
+        std::shared_ptr<std::atomic<size_type>> m_allocated_bytes;
+        [[no_unique_address]] Stats m_stats;
+    };
+
+    // Equal allocators share the counter, whatever the element type
+    template <typename T, typename U, typename Stats>
+    bool operator==(const Counting_allocator<T, Stats> &lhs, const Counting_allocator<U, Stats> &rhs) noexcept
+    {
+        return &lhs.counter() == &rhs.counter();
+    }
+
+}
+
+namespace medium
+{
+
+    /**
+     * @brief Monotonic arena: memory is handed out by bumping a pointer and released only all at once.
+     *
+     * Chunks are taken from the upstream resource as needed (each twice the previous one) and chained.
+     * reset() rewinds to the first chunk in O(1) keeping the chunks for reuse, so scratch data of a request
+     * costs no malloc/free after the first few requests; release() returns the chunks upstream.
+     * Usable directly as std::pmr::memory_resource (e.g. with std::pmr::vector) or through Arena_allocator.
+     */
+    class Monotonic_arena : public std::pmr::memory_resource
+    {
+    public:
+        explicit Monotonic_arena(std::size_t initial_chunk_size = 4096, std::pmr::memory_resource *upstream = std::pmr::new_delete_resource()) noexcept
+            : m_upstream{upstream}, m_next_chunk_size{std::max(initial_chunk_size, sizeof(Chunk))}
+        {
+        }
+
+        Monotonic_arena(const Monotonic_arena &) = delete;
+        Monotonic_arena &operator=(const Monotonic_arena &) = delete;
+
+        ~Monotonic_arena() noexcept override
+        {
+            release();
+        }
+
+        [[nodiscard]] void *allocate_bytes(std::size_t bytes, std::size_t alignment)
+        {
+            // Aligning may step past the end of the chunk
+            auto *ptr = align(m_next, alignment);
+            if (ptr == nullptr || ptr > m_end || bytes > static_cast<std::size_t>(m_end - ptr))
+            {
+                ptr = next_chunk(bytes, alignment);
+            }
+            m_next = ptr + bytes;
+            return ptr;
+        }
+
+        // Everything allocated so far is gone, chunks stay for the next allocations
+        void reset() noexcept
+        {
+            m_current = m_first;
+            set_bump(m_current);
+        }
+
+        void release() noexcept
+        {
+            while (m_first != nullptr)
+            {
+                Chunk *next = m_first->m_next;
+                m_upstream->deallocate(m_first, m_first->m_size, alignof(Chunk));
+                m_first = next;
+            }
+            m_current = nullptr;
+            m_next = nullptr;
+            m_end = nullptr;
+        }
+
+        // Bytes in all chunks
+        std::size_t capacity() const noexcept
+        {
+            std::size_t bytes{0U};
+            for (const Chunk *chunk = m_first; chunk != nullptr; chunk = chunk->m_next)
+            {
+                bytes += chunk->m_size - sizeof(Chunk);
+            }
+            return bytes;
+        }
+
+    protected:
+        void *do_allocate(std::size_t bytes, std::size_t alignment) override
+        {
+            return allocate_bytes(bytes, alignment);
+        }
+
+        void do_deallocate(void *, std::size_t, std::size_t) override
+        {
+        }
+
+        bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override
+        {
+            return this == &other;
+        }
+
+    private:
+        // Header of a chunk, memory follows
+        struct alignas(std::max_align_t) Chunk
+        {
+            Chunk *m_next;
+            std::size_t m_size;
+        };
+
+        static unsigned char *align(unsigned char *ptr, std::size_t alignment) noexcept
+        {
+            if (ptr == nullptr)
+            {
+                return nullptr;
+            }
+            const auto address = reinterpret_cast<std::uintptr_t>(ptr);
+            return ptr + ((alignment - address % alignment) % alignment);
+        }
+
+        void set_bump(Chunk *chunk) noexcept
+        {
+            m_next = chunk == nullptr ? nullptr : reinterpret_cast<unsigned char *>(chunk + 1);
+            m_end = chunk == nullptr ? nullptr : reinterpret_cast<unsigned char *>(chunk) + chunk->m_size;
+        }
+
+        // Next kept chunk if the request fits in it, otherwise a new one linked after the current one
+        unsigned char *next_chunk(std::size_t bytes, std::size_t alignment)
+        {
+            constexpr std::size_t MAX_SIZE = std::numeric_limits<std::size_t>::max();
+            if (alignment > MAX_SIZE - sizeof(Chunk) || bytes > MAX_SIZE - sizeof(Chunk) - alignment)
+            {
+                throw std::bad_alloc();
+            }
+
+            Chunk *next = m_current == nullptr ? m_first : m_current->m_next;
+            if (next == nullptr || bytes + alignment > next->m_size - sizeof(Chunk))
+            {
+                const std::size_t size = std::max(m_next_chunk_size, sizeof(Chunk) + bytes + alignment);
+                m_next_chunk_size = size > MAX_SIZE / 2U ? size : 2U * size;
+
+                auto *chunk = static_cast<Chunk *>(m_upstream->allocate(size, alignof(Chunk)));
+                chunk->m_size = size;
+                chunk->m_next = next;
+                if (m_current == nullptr)
+                {
+                    m_first = chunk;
+                }
+                else
+                {
+                    m_current->m_next = chunk;
+                }
+                next = chunk;
+            }
+
+            m_current = next;
+            set_bump(m_current);
+            return align(m_next, alignment);
+        }
+
+        std::pmr::memory_resource *m_upstream;
+        std::size_t m_next_chunk_size;
+        Chunk *m_first{nullptr};
+        Chunk *m_current{nullptr};
+        unsigned char *m_next{nullptr};
+        unsigned char *m_end{nullptr};
+    };
+
+    /**
+     * @brief Custom allocator that allocates memory from a monotonic arena.
+     *
+     * Deallocation does nothing, memory comes back with Monotonic_arena::reset(). Unlike
+     * std::pmr::polymorphic_allocator, allocation is not a virtual call. Copies and rebinds share the arena;
+     * the allocator propagates with the memory on move, copy assignment and swap, as complex::Shared_arena_allocator.
+     *
+     * @tparam T The type of elements to allocate memory for.
+     */
+    template <typename T>
+    class Arena_allocator
+    {
+    public:
+        using value_type = T;
+        using size_type = std::size_t;
+        using difference_type = std::ptrdiff_t;
+        using propagate_on_container_copy_assignment = std::true_type;
+        using propagate_on_container_move_assignment = std::true_type;
+        using propagate_on_container_swap = std::true_type;
+
+        explicit Arena_allocator(Monotonic_arena &arena) noexcept : m_arena{&arena}
+        {
+        }
+
+        template <typename U>
+        Arena_allocator(const Arena_allocator<U> &other) noexcept : m_arena{other.m_arena}
+        {
+        }
+
+        [[nodiscard]] T *allocate(size_type n)
+        {
+            if (n > std::numeric_limits<size_type>::max() / sizeof(T))
+            {
+                throw std::bad_alloc();
+            }
+            return static_cast<T *>(m_arena->allocate_bytes(n * sizeof(T), alignof(T)));
+        }
+
+        void deallocate(T *, size_type) noexcept
+        {
+        }
+
+        Monotonic_arena &arena() const noexcept
+        {
+            return *m_arena;
+        }
+
+    private:
+        template <typename U>
+        friend class Arena_allocator;
+
+        Monotonic_arena *m_arena;
+    };
+
+    // Equal allocators share the arena, whatever the element type
+    template <typename T, typename U>
+    bool operator==(const Arena_allocator<T> &lhs, const Arena_allocator<U> &rhs) noexcept
+    {
+        return &lhs.arena() == &rhs.arena();
+    }
+
+}
+
+namespace complex
+{
+
+    /**
+     * @brief Custom allocator that manages sections of a fixed-size area.
+     *
+     * Free sections are kept twice: ordered by address, to merge a freed section with its free neighbours,
+     * and ordered by size, to find the smallest section that fits (best fit) in O(log n).
+     *
+     * @tparam T The type of elements to allocate memory for.
+     * @tparam MAX Number of elements in the area.
+     * @tparam Stats Statistics policy (see allocation_stats.hpp).
+     */
+    template <typename T, std::size_t MAX = 1024, typename Stats = stats::No_stats>
+    class Safe_allocator
+    {
+    public:
+        using value_type = T;
+        using size_type = std::size_t;
+        using difference_type = std::ptrdiff_t;
+
+        template <typename U>
+        struct rebind
+        {
+            using other = Safe_allocator<U, MAX, Stats>;
+        };
+
+        Safe_allocator() noexcept : m_allocated_sections{}, m_free_sections{{&m_memory[0], MAX}}, m_free_sizes{{MAX, &m_memory[0]}}
+        {
+        }
+
+        // Rebound allocator (e.g. for nodes of std::list) gets an empty area of its own, sections of the other
+        // point into the other's memory; only statistics are shared
+        template <typename U>
+        Safe_allocator(const Safe_allocator<U, MAX, Stats> &other) noexcept : Safe_allocator{}
+        {
+            m_stats = other.m_stats;
+        }
+
+        [[nodiscard]] constexpr T *allocate(size_type n)
+        {
+            // Best fit: smallest free section of at least n elements
+            auto it = m_free_sizes.lower_bound({n, nullptr});
+            if (it == std::end(m_free_sizes))
+            {
+                throw std::bad_alloc();
+            }
+
+            const auto [length, begin] = *it;
+            m_free_sizes.erase(it);
+            m_free_sections.erase(Section(begin, length));
+
+            if (length > n)
+            {
+                insert_free(Section(begin + n, length - n));
+            }
+
+            m_allocated_sections.insert(Section(begin, n));
+            m_allocated_length += n;
+            m_stats.on_allocate(begin, n * sizeof(T));
+
+            return begin;
+        }
+
+        constexpr void deallocate(T *ptr, size_type n) noexcept
+        {
+            auto it = m_allocated_sections.find(Section(ptr, n));
+            if (it == std::end(m_allocated_sections) || it->m_length != n)
+            {
+                std::cerr << "Invalid deallocation requested?\n";
+                return;
+            }
+            m_allocated_sections.erase(it);
+            m_allocated_length -= n;
+
+            // Merge with free neighbouring sections
+            Section freed(ptr, n);
+            auto next = m_free_sections.lower_bound(freed);
+            if (next != std::end(m_free_sections) && freed.m_begin + freed.m_length == next->m_begin)
+            {
+                freed.m_length += next->m_length;
+                next = erase_free(next);
+            }
+            if (next != std::begin(m_free_sections))
+            {
+                auto previous = std::prev(next);
+                if (previous->m_begin + previous->m_length == freed.m_begin)
+                {
+                    freed = Section(previous->m_begin, previous->m_length + freed.m_length);
+                    erase_free(previous);
+                }
+            }
+            insert_free(freed);
+            m_stats.on_deallocate(ptr, n * sizeof(T));
+        }
+
+        // Elements in the biggest free section, largest request that can succeed
+        size_type largest_free_section() const noexcept
+        {
+            return m_free_sizes.empty() ? 0U : m_free_sizes.rbegin()->first;
+        }
+
+        size_type free_sections() const noexcept
+        {
+            return m_free_sections.size();
+        }
+
+        size_type allocated_length() const noexcept
+        {
+            return m_allocated_length;
+        }
+
+        const Stats &stats() const noexcept
+        {
+            return m_stats;
+        }
+
+        // On demand, walks all the sections
+        void show_stats(std::ostream &stream = std::cout) const
+        {
+            stream << "Allocated sections: " << m_allocated_sections.size() << ", bytes: " << sizeof(T) * m_allocated_length << "\n";
+            for (const auto &section : m_allocated_sections)
+            {
+                stream << "\tSection at " << static_cast<const void *>(section.m_begin) << ", bytes: " << sizeof(T) * section.m_length << "\n";
+            }
+            stream << "Free sections: " << m_free_sections.size() << ", bytes: " << sizeof(T) * (MAX - m_allocated_length) << "\n";
+            for (const auto &section : m_free_sections)
+            {
+                stream << "\tSection at " << static_cast<const void *>(section.m_begin) << ", bytes: " << sizeof(T) * section.m_length << "\n";
+            }
+        }
+
+    private:
+        template <typename U, std::size_t, typename>
+        friend class Safe_allocator;
+
+        struct Section
+        {
+            Section(T *begin, size_type n) : m_begin{begin}, m_length{n} {}
+
+            T *m_begin;
+            size_type m_length;
+        };
+
+        friend bool operator<(const Section &lhs, const Section &rhs)
+        {
+            return lhs.m_begin < rhs.m_begin;
+        }
+
+        friend bool operator==(const Section &lhs, const Section &rhs)
+        {
+            return lhs.m_begin == rhs.m_begin;
+        }
+
+        void insert_free(const Section &section)
+        {
+            m_free_sections.insert(section);
+            m_free_sizes.insert({section.m_length, section.m_begin});
+        }
+
+        auto erase_free(typename std::set<Section>::iterator it)
+        {
+            m_free_sizes.erase({it->m_length, it->m_begin});
+            return m_free_sections.erase(it);
+        }
+
+        T m_memory[MAX];
+
+        std::set<Section> m_allocated_sections;
+        // By address
+        std::set<Section> m_free_sections;
+        // By size, then address
+        std::set<std::pair<size_type, T *>> m_free_sizes;
+        size_type m_allocated_length{0U};
+        [[no_unique_address]] Stats m_stats;
+    };
+
+}
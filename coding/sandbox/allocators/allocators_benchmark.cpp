@@ -0,0 +1,434 @@
+// Copyright (c) 2024, Piotr Staniszewski
+
+#include "allocators.hpp"
+#include "boundary_tag_allocator.hpp"
+#include "buddy_allocator.hpp"
+#include "mapped_memory.hpp"
+#include "pool_allocator.hpp"
+#include "shared_arena_allocator.hpp"
+#include "thread_caching_allocator.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <list>
+#include <map>
+#include <memory>
+#include <memory_resource>
+#include <random>
+#include <type_traits>
+#include <vector>
+
+namespace
+{
+    // Allocations of random sizes, each freed after a random number of other allocations
+    struct Trace_step
+    {
+        std::size_t m_length;
+        std::size_t m_lifetime;
+    };
+
+    std::vector<Trace_step> random_trace(std::size_t steps, std::size_t max_length, std::size_t max_lifetime)
+    {
+        std::mt19937 generator{42U};
+        std::uniform_int_distribution<std::size_t> length{1U, max_length};
+        std::uniform_int_distribution<std::size_t> lifetime{1U, max_lifetime};
+        std::vector<Trace_step> trace(steps);
+        for (auto &step : trace)
+        {
+            step = {length(generator), lifetime(generator)};
+        }
+        return trace;
+    }
+
+    // Replays the trace, a live allocation is freed when its lifetime ends; failed allocations are skipped.
+    // Returns number of failed allocations.
+    template <typename Allocator>
+    std::size_t replay(Allocator &allocator, const std::vector<Trace_step> &trace)
+    {
+        using Pointer = typename Allocator::value_type *;
+        struct Live
+        {
+            Pointer m_ptr;
+            std::size_t m_length;
+        };
+
+        const std::size_t slots = 256U;
+        std::vector<std::vector<Live>> expiring(slots);
+        std::size_t failed{0U};
+
+        for (std::size_t step = 0U; step < trace.size(); ++step)
+        {
+            for (const auto &live : expiring[step % slots])
+            {
+                allocator.deallocate(live.m_ptr, live.m_length);
+            }
+            expiring[step % slots].clear();
+
+            try
+            {
+                auto ptr = allocator.allocate(trace[step].m_length);
+                benchmark::DoNotOptimize(ptr);
+                expiring[(step + trace[step].m_lifetime) % slots].push_back({ptr, trace[step].m_length});
+            }
+            catch (const std::bad_alloc &)
+            {
+                ++failed;
+            }
+        }
+
+        for (const auto &slot : expiring)
+        {
+            for (const auto &live : slot)
+            {
+                allocator.deallocate(live.m_ptr, live.m_length);
+            }
+        }
+
+        return failed;
+    }
+}
+
+// Same 64 KB area for all: bookkeeping in std::set nodes, boundary tags inside the area or buddy bitmaps
+// (sizes rounded up to powers of two, so more failed allocations under pressure)
+template <typename Allocator>
+static void benchmark_area_allocator_trace(benchmark::State &state)
+{
+    const auto trace = random_trace(16U * 1024U, static_cast<std::size_t>(state.range(0)), 255U);
+    std::size_t failed{0U};
+    for (auto _ : state)
+    {
+        auto allocator = std::make_unique<Allocator>();
+        failed = replay(*allocator, trace);
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(trace.size()));
+    state.counters["failed"] = static_cast<double>(failed);
+}
+BENCHMARK_TEMPLATE(benchmark_area_allocator_trace, complex::Safe_allocator<char, 64U * 1024U>)->Arg(16)->Arg(64)->Arg(256)->Arg(1024);
+
+// Arena owned outside, the allocator is only a handle to it
+template <typename Arena>
+static void benchmark_arena_trace(benchmark::State &state)
+{
+    const auto trace = random_trace(16U * 1024U, static_cast<std::size_t>(state.range(0)), 255U);
+    std::size_t failed{0U};
+    for (auto _ : state)
+    {
+        auto arena = std::make_unique<Arena>();
+        complex::Shared_arena_allocator<char, Arena> allocator{*arena};
+        failed = replay(allocator, trace);
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(trace.size()));
+    state.counters["failed"] = static_cast<double>(failed);
+}
+BENCHMARK_TEMPLATE(benchmark_arena_trace, complex::Boundary_tag_arena<64U * 1024U>)->Arg(16)->Arg(64)->Arg(256)->Arg(1024);
+BENCHMARK_TEMPLATE(benchmark_arena_trace, complex::Buddy_arena<64U * 1024U>)->Arg(16)->Arg(64)->Arg(256)->Arg(1024);
+
+// Cost of the statistics policies
+BENCHMARK_TEMPLATE(benchmark_area_allocator_trace, complex::Safe_allocator<char, 64U * 1024U, stats::Atomic_counters>)->Arg(64);
+BENCHMARK_TEMPLATE(benchmark_area_allocator_trace, complex::Safe_allocator<char, 64U * 1024U, stats::Tracing<>>)->Arg(64);
+
+static void benchmark_std_allocator_trace(benchmark::State &state)
+{
+    const auto trace = random_trace(16U * 1024U, static_cast<std::size_t>(state.range(0)), 255U);
+    for (auto _ : state)
+    {
+        std::allocator<char> allocator;
+        benchmark::DoNotOptimize(replay(allocator, trace));
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(trace.size()));
+}
+BENCHMARK(benchmark_std_allocator_trace)->Arg(16)->Arg(64)->Arg(256)->Arg(1024);
+
+// Fragmentation after the trace is half replayed: 1 - largest free section / free memory
+static void benchmark_safe_allocator_fragmentation(benchmark::State &state)
+{
+    using Allocator = complex::Safe_allocator<char, 64U * 1024U>;
+
+    const auto trace = random_trace(8U * 1024U, static_cast<std::size_t>(state.range(0)), 4096U);
+    double fragmentation{0.0};
+    double free_sections{0.0};
+    for (auto _ : state)
+    {
+        auto allocator = std::make_unique<Allocator>();
+        std::vector<std::pair<char *, std::size_t>> live;
+        std::mt19937 generator{7U};
+        for (const auto &step : trace)
+        {
+            if (!live.empty() && generator() % 2U == 0U)
+            {
+                const auto victim = generator() % live.size();
+                allocator->deallocate(live[victim].first, live[victim].second);
+                live[victim] = live.back();
+                live.pop_back();
+            }
+            try
+            {
+                live.emplace_back(allocator->allocate(step.m_length), step.m_length);
+            }
+            catch (const std::bad_alloc &)
+            {
+            }
+        }
+
+        const auto free_length = 64U * 1024U - allocator->allocated_length();
+        fragmentation = free_length == 0U ? 0.0 : 1.0 - static_cast<double>(allocator->largest_free_section()) / static_cast<double>(free_length);
+        free_sections = static_cast<double>(allocator->free_sections());
+
+        for (const auto &[ptr, length] : live)
+        {
+            allocator->deallocate(ptr, length);
+        }
+    }
+    state.counters["fragmentation"] = fragmentation;
+    state.counters["free_sections"] = free_sections;
+}
+BENCHMARK(benchmark_safe_allocator_fragmentation)->Arg(16)->Arg(256);
+
+// Node-based container: one allocation per insert, argument is number of inserts
+template <typename Allocator>
+static void benchmark_map_inserts(benchmark::State &state)
+{
+    std::mt19937 generator{42U};
+    std::vector<int> keys(static_cast<std::size_t>(state.range(0)));
+    for (auto &key : keys)
+    {
+        key = static_cast<int>(generator());
+    }
+
+    for (auto _ : state)
+    {
+        std::map<int, int, std::less<int>, Allocator> map;
+        for (const auto key : keys)
+        {
+            map.emplace(key, key);
+        }
+        benchmark::DoNotOptimize(map.size());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_TEMPLATE(benchmark_map_inserts, std::allocator<std::pair<const int, int>>)->RangeMultiplier(16)->Range(256, 1 << 20);
+BENCHMARK_TEMPLATE(benchmark_map_inserts, medium::Pool_allocator<std::pair<const int, int>>)->RangeMultiplier(16)->Range(256, 1 << 20);
+
+// Cost of the process-wide profile
+BENCHMARK_TEMPLATE(benchmark_map_inserts, simple::Counting_allocator<std::pair<const int, int>>)->Arg(4096);
+BENCHMARK_TEMPLATE(benchmark_map_inserts, simple::Counting_allocator<std::pair<const int, int>, stats::Profiling>)->Arg(4096);
+
+// Scratch data of a request: a few vectors grown from empty, argument is elements per vector
+static void benchmark_scratch_std_allocator(benchmark::State &state)
+{
+    const auto elements = static_cast<int>(state.range(0));
+    for (auto _ : state)
+    {
+        for (int vector = 0; vector < 8; ++vector)
+        {
+            std::vector<int> scratch;
+            for (int i = 0; i < elements; ++i)
+            {
+                scratch.push_back(i);
+            }
+            benchmark::DoNotOptimize(scratch.data());
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * 8 * elements);
+}
+BENCHMARK(benchmark_scratch_std_allocator)->RangeMultiplier(8)->Range(8, 8 << 12);
+
+static void benchmark_scratch_arena_allocator(benchmark::State &state)
+{
+    const auto elements = static_cast<int>(state.range(0));
+    medium::Monotonic_arena arena;
+    for (auto _ : state)
+    {
+        for (int vector = 0; vector < 8; ++vector)
+        {
+            std::vector<int, medium::Arena_allocator<int>> scratch{medium::Arena_allocator<int>{arena}};
+            for (int i = 0; i < elements; ++i)
+            {
+                scratch.push_back(i);
+            }
+            benchmark::DoNotOptimize(scratch.data());
+        }
+        arena.reset();
+    }
+    state.SetItemsProcessed(state.iterations() * 8 * elements);
+}
+BENCHMARK(benchmark_scratch_arena_allocator)->RangeMultiplier(8)->Range(8, 8 << 12);
+
+// Template argument is the memory resource: the arena or the standard monotonic buffer
+template <typename Resource>
+static void benchmark_scratch_pmr(benchmark::State &state)
+{
+    const auto elements = static_cast<int>(state.range(0));
+    Resource resource;
+    for (auto _ : state)
+    {
+        for (int vector = 0; vector < 8; ++vector)
+        {
+            std::pmr::vector<int> scratch{&resource};
+            for (int i = 0; i < elements; ++i)
+            {
+                scratch.push_back(i);
+            }
+            benchmark::DoNotOptimize(scratch.data());
+        }
+        if constexpr (std::is_same_v<Resource, medium::Monotonic_arena>)
+        {
+            resource.reset();
+        }
+        else
+        {
+            resource.release();
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * 8 * elements);
+}
+BENCHMARK_TEMPLATE(benchmark_scratch_pmr, medium::Monotonic_arena)->RangeMultiplier(8)->Range(8, 8 << 12);
+BENCHMARK_TEMPLATE(benchmark_scratch_pmr, std::pmr::monotonic_buffer_resource)->RangeMultiplier(8)->Range(8, 8 << 12);
+
+// Every thread allocates a batch of blocks of random small sizes and frees it, argument is batch size
+static void benchmark_threads_malloc(benchmark::State &state)
+{
+    const auto batch = static_cast<std::size_t>(state.range(0));
+    std::mt19937 generator{static_cast<unsigned>(state.thread_index())};
+    std::uniform_int_distribution<std::size_t> size{1U, 256U};
+    std::vector<std::size_t> sizes(batch);
+    for (auto &block : sizes)
+    {
+        block = size(generator);
+    }
+
+    std::vector<void *> blocks(batch);
+    for (auto _ : state)
+    {
+        for (std::size_t i = 0U; i < batch; ++i)
+        {
+            blocks[i] = std::malloc(sizes[i]);
+            benchmark::DoNotOptimize(blocks[i]);
+        }
+        for (std::size_t i = 0U; i < batch; ++i)
+        {
+            std::free(blocks[i]);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(benchmark_threads_malloc)->Arg(256)->ThreadRange(1, 8)->UseRealTime();
+
+static void benchmark_threads_thread_caching(benchmark::State &state)
+{
+    const auto batch = static_cast<std::size_t>(state.range(0));
+    std::mt19937 generator{static_cast<unsigned>(state.thread_index())};
+    std::uniform_int_distribution<std::size_t> size{1U, 256U};
+    std::vector<std::size_t> sizes(batch);
+    for (auto &block : sizes)
+    {
+        block = size(generator);
+    }
+
+    concurrent::Thread_caching_allocator<char> allocator;
+    std::vector<char *> blocks(batch);
+    for (auto _ : state)
+    {
+        for (std::size_t i = 0U; i < batch; ++i)
+        {
+            blocks[i] = allocator.allocate(sizes[i]);
+            benchmark::DoNotOptimize(blocks[i]);
+        }
+        for (std::size_t i = 0U; i < batch; ++i)
+        {
+            allocator.deallocate(blocks[i], sizes[i]);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(benchmark_threads_thread_caching)->Arg(256)->ThreadRange(1, 8)->UseRealTime();
+
+// Move assignment of a list between containers of different arenas: a propagating allocator moves
+// the nodes, std::pmr::polymorphic_allocator doesn't propagate and copies element by element
+template <typename List>
+static typename List::allocator_type list_allocator(medium::Monotonic_arena &arena)
+{
+    if constexpr (std::is_same_v<List, std::pmr::list<int>>)
+    {
+        return &arena;
+    }
+    else
+    {
+        return typename List::allocator_type{arena};
+    }
+}
+
+template <typename List>
+static void benchmark_list_move_between_arenas(benchmark::State &state)
+{
+    medium::Monotonic_arena arena1;
+    medium::Monotonic_arena arena2;
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        List source{list_allocator<List>(arena1)};
+        for (int i = 0; i < state.range(0); ++i)
+        {
+            source.push_back(i);
+        }
+        List target{list_allocator<List>(arena2)};
+        state.ResumeTiming();
+
+        target = std::move(source);
+        benchmark::DoNotOptimize(target.size());
+
+        state.PauseTiming();
+        source.clear();
+        target.clear();
+        arena1.reset();
+        arena2.reset();
+        state.ResumeTiming();
+    }
+}
+
+BENCHMARK_TEMPLATE(benchmark_list_move_between_arenas, std::list<int, complex::Shared_arena_allocator<int, medium::Monotonic_arena>>)->RangeMultiplier(16)->Range(16, 1 << 16);
+BENCHMARK_TEMPLATE(benchmark_list_move_between_arenas, std::pmr::list<int>)->RangeMultiplier(16)->Range(16, 1 << 16);
+
+// Random reads and writes over a big buffer, argument is its size in MB: with 4 KB pages almost every
+// access misses the TLB, a 2 MB page covers 512 times more memory per entry
+static void random_access(benchmark::State &state, unsigned char *data, std::size_t size)
+{
+    std::memset(data, 0, size);
+    std::mt19937_64 generator{42U};
+    for (auto _ : state)
+    {
+        for (int i = 0; i < 1024; ++i)
+        {
+            ++data[generator() % size];
+        }
+    }
+    benchmark::DoNotOptimize(data);
+    state.SetItemsProcessed(state.iterations() * 1024);
+}
+
+static void benchmark_random_access_heap(benchmark::State &state)
+{
+    const std::size_t size = static_cast<std::size_t>(state.range(0)) << 20U;
+    auto data = std::make_unique<unsigned char[]>(size);
+    random_access(state, data.get(), size);
+}
+
+BENCHMARK(benchmark_random_access_heap)->Arg(256);
+
+template <backing::Huge_pages HUGE_PAGES>
+static void benchmark_random_access_mapped(benchmark::State &state)
+{
+    const std::size_t size = static_cast<std::size_t>(state.range(0)) << 20U;
+    backing::Mapped_memory memory{size, backing::Options{HUGE_PAGES, true}};
+    random_access(state, static_cast<unsigned char *>(memory.data()), size);
+    state.counters["huge_pages"] = memory.explicit_huge_pages() || memory.transparent_huge_pages();
+}
+
+BENCHMARK_TEMPLATE(benchmark_random_access_mapped, backing::Huge_pages::NONE)->Arg(256);
+BENCHMARK_TEMPLATE(benchmark_random_access_mapped, backing::Huge_pages::TRANSPARENT)->Arg(256);
+
+BENCHMARK_MAIN();
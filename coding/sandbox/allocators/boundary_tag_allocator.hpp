@@ -0,0 +1,253 @@
+// Copyright (c) 2024, Piotr Staniszewski
+
+#pragma once
+
+#include "shared_arena_allocator.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <new>
+
+namespace complex
+{
+
+    /**
+     * @brief Area that keeps all its bookkeeping inside itself.
+     *
+     * Every block starts with a header and ends with a footer (boundary tags), both holding block size
+     * and allocated flag, so the neighbours of a freed block are found in O(1) and merged right away.
+     * Free blocks are linked into lists by size class (powers of two) through their own payload.
+     * Links are offsets, not pointers, so the area stays valid when copied. Nothing is allocated besides the area.
+     *
+     * Layout: [prologue footer][block][block]...[epilogue header], blocks are multiples of 16 bytes
+     * and payloads are 16 bytes aligned.
+     *
+     * Interface is the one of std::pmr::memory_resource, without virtual calls.
+     *
+     * @tparam BYTES Size of the area in bytes, multiple of 16.
+     */
+    template <std::size_t BYTES>
+    class Boundary_tag_arena
+    {
+    public:
+        using size_type = std::size_t;
+
+        static constexpr size_type ALIGNMENT = 16U;
+
+        static_assert(BYTES % 16U == 0U && BYTES >= 64U, "Area must be a multiple of 16 bytes");
+
+        Boundary_tag_arena() noexcept
+        {
+            m_bins.fill(NONE);
+
+            write_tag(0U, 0U, true);
+            write_tag(BYTES - TAG, 0U, true);
+
+            const size_type first = TAG;
+            const size_type size = BYTES - 2U * TAG;
+            write_tags(first, size, false);
+            push_free(first, size);
+        }
+
+        [[nodiscard]] void *allocate(size_type bytes, size_type alignment = ALIGNMENT)
+        {
+            if (bytes > BYTES - 2U * TAG || alignment > ALIGNMENT)
+            {
+                throw std::bad_alloc();
+            }
+            const size_type size = block_size(bytes);
+
+            const size_type block = find_free(size);
+            if (block == NONE)
+            {
+                throw std::bad_alloc();
+            }
+
+            const size_type available = read_size(block);
+            pop_free(block, available);
+
+            // Split when the rest can hold a free block
+            if (available - size >= MIN_BLOCK)
+            {
+                write_tags(block, size, true);
+                write_tags(block + size, available - size, false);
+                push_free(block + size, available - size);
+            }
+            else
+            {
+                write_tags(block, available, true);
+            }
+
+            return m_memory + block + TAG;
+        }
+
+        void deallocate(void *ptr, size_type = 0U, size_type = ALIGNMENT) noexcept
+        {
+            size_type block = static_cast<size_type>(static_cast<unsigned char *>(ptr) - m_memory) - TAG;
+            if (!read_allocated(block))
+            {
+                std::cerr << "Invalid deallocation requested?\n";
+                return;
+            }
+            size_type size = read_size(block);
+
+            // Merge with free neighbours, prologue and epilogue are always allocated
+            const size_type next = block + size;
+            if (!read_allocated(next))
+            {
+                const size_type next_size = read_size(next);
+                pop_free(next, next_size);
+                size += next_size;
+            }
+            if (!read_allocated(block - TAG))
+            {
+                const size_type previous_size = read_size(block - TAG);
+                block -= previous_size;
+                pop_free(block, previous_size);
+                size += previous_size;
+            }
+
+            write_tags(block, size, false);
+            push_free(block, size);
+        }
+
+        // Bytes in the biggest free block, payload of the largest request that can succeed is 16 less
+        size_type largest_free_block() const noexcept
+        {
+            for (size_type bin = BINS; bin-- > 0U;)
+            {
+                size_type largest{0U};
+                for (size_type block = m_bins[bin]; block != NONE; block = read_link(block, NEXT))
+                {
+                    largest = std::max(largest, read_size(block));
+                }
+                if (largest != 0U)
+                {
+                    return largest;
+                }
+            }
+            return 0U;
+        }
+
+    private:
+        static constexpr size_type TAG = sizeof(size_type);
+        static constexpr size_type ALLOCATED = 1U;
+        // Header, links to previous and next free block, footer
+        static constexpr size_type MIN_BLOCK = 32U;
+        static constexpr size_type NEXT = 0U;
+        static constexpr size_type PREVIOUS = 1U;
+        static constexpr size_type NONE = std::numeric_limits<size_type>::max();
+        static constexpr size_type BINS = std::bit_width(BYTES);
+
+        static constexpr size_type block_size(size_type bytes) noexcept
+        {
+            return std::max(MIN_BLOCK, (bytes + 2U * TAG + 15U) & ~size_type{15U});
+        }
+
+        static constexpr size_type bin(size_type size) noexcept
+        {
+            return std::bit_width(size >> 1U);
+        }
+
+        size_type read(size_type offset) const noexcept
+        {
+            size_type value;
+            std::memcpy(&value, m_memory + offset, sizeof(value));
+            return value;
+        }
+
+        void write(size_type offset, size_type value) noexcept
+        {
+            std::memcpy(m_memory + offset, &value, sizeof(value));
+        }
+
+        size_type read_size(size_type tag) const noexcept { return read(tag) & ~ALLOCATED; }
+
+        bool read_allocated(size_type tag) const noexcept { return (read(tag) & ALLOCATED) != 0U; }
+
+        void write_tag(size_type tag, size_type size, bool allocated) noexcept { write(tag, size | (allocated ? ALLOCATED : 0U)); }
+
+        void write_tags(size_type block, size_type size, bool allocated) noexcept
+        {
+            write_tag(block, size, allocated);
+            write_tag(block + size - TAG, size, allocated);
+        }
+
+        size_type read_link(size_type block, size_type link) const noexcept { return read(block + TAG + link * TAG); }
+
+        void write_link(size_type block, size_type link, size_type value) noexcept { write(block + TAG + link * TAG, value); }
+
+        void push_free(size_type block, size_type size) noexcept
+        {
+            const size_type head = m_bins[bin(size)];
+            write_link(block, NEXT, head);
+            write_link(block, PREVIOUS, NONE);
+            if (head != NONE)
+            {
+                write_link(head, PREVIOUS, block);
+            }
+            m_bins[bin(size)] = block;
+        }
+
+        void pop_free(size_type block, size_type size) noexcept
+        {
+            const size_type next = read_link(block, NEXT);
+            const size_type previous = read_link(block, PREVIOUS);
+            if (previous != NONE)
+            {
+                write_link(previous, NEXT, next);
+            }
+            else
+            {
+                m_bins[bin(size)] = next;
+            }
+            if (next != NONE)
+            {
+                write_link(next, PREVIOUS, previous);
+            }
+        }
+
+        // First fit in the size class of the request, any block of a bigger class fits
+        size_type find_free(size_type size) const noexcept
+        {
+            for (size_type block = m_bins[bin(size)]; block != NONE; block = read_link(block, NEXT))
+            {
+                if (read_size(block) >= size)
+                {
+                    return block;
+                }
+            }
+            for (size_type next_bin = bin(size) + 1U; next_bin < BINS; ++next_bin)
+            {
+                if (m_bins[next_bin] != NONE)
+                {
+                    return m_bins[next_bin];
+                }
+            }
+            return NONE;
+        }
+
+        alignas(16) unsigned char m_memory[BYTES];
+
+        std::array<size_type, BINS> m_bins;
+    };
+
+    /**
+     * @brief Custom allocator over a boundary tag area.
+     *
+     * Only a handle: containers move their buffers between objects, so an area embedded in the allocator
+     * would stay behind in the moved-from one. The area is owned outside and shared by copies and rebinds.
+     *
+     * @tparam T The type of elements to allocate memory for.
+     * @tparam BYTES Size of the area in bytes, multiple of 16.
+     */
+    template <typename T, std::size_t BYTES = 4096>
+    using Boundary_tag_allocator = Shared_arena_allocator<T, Boundary_tag_arena<BYTES>>;
+
+}
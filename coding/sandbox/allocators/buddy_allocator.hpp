@@ -0,0 +1,210 @@
+// Copyright (c) 2024, Piotr Staniszewski
+
+#pragma once
+
+#include "shared_arena_allocator.hpp"
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <new>
+
+namespace complex
+{
+
+    /**
+     * @brief Binary buddy system over an area of power-of-two size.
+     *
+     * Blocks are MIN_BLOCK << order bytes and start at a multiple of their size, so the buddy of a block
+     * is found by flipping one bit of its offset. Allocation takes the smallest free order that fits
+     * (bitmap of non-empty orders, O(1)) and splits it down, freed blocks merge with free buddies up,
+     * both in O(log n). One bit per pair of buddies holds "exactly one of them is free", flipped whenever
+     * either enters or leaves its free list, so checking the buddy costs no memory in the block itself.
+     * Free lists are linked through the payload with offsets. Sizes are rounded up to powers of two,
+     * deallocation needs the size of the request.
+     *
+     * Interface is the one of std::pmr::memory_resource, without virtual calls.
+     *
+     * @tparam BYTES Size of the area in bytes, power of two.
+     * @tparam MIN_BLOCK Size of the smallest block in bytes, power of two, at least 16.
+     */
+    template <std::size_t BYTES, std::size_t MIN_BLOCK = 16U>
+    class Buddy_arena
+    {
+    public:
+        using size_type = std::size_t;
+
+        static constexpr size_type ALIGNMENT = MIN_BLOCK;
+
+        static_assert(std::has_single_bit(BYTES) && std::has_single_bit(MIN_BLOCK), "Sizes must be powers of two");
+        static_assert(MIN_BLOCK >= 2U * sizeof(size_type) && BYTES >= MIN_BLOCK, "Free block holds two links");
+
+        Buddy_arena() noexcept
+        {
+            m_lists.fill(NONE);
+            m_pairs.fill(0U);
+            push_free(0U, MAX_ORDER);
+        }
+
+        [[nodiscard]] void *allocate(size_type bytes, size_type alignment = ALIGNMENT)
+        {
+            if (bytes > BYTES || alignment > ALIGNMENT)
+            {
+                throw std::bad_alloc();
+            }
+            const size_type order = order_of(bytes);
+
+            // Smallest non-empty order that fits
+            const size_type available = m_free_orders >> order;
+            if (available == 0U)
+            {
+                throw std::bad_alloc();
+            }
+            size_type current = order + static_cast<size_type>(std::countr_zero(available));
+            const size_type block = m_lists[current];
+            pop_free(block, current);
+
+            // Upper halves go back to the free lists
+            while (current > order)
+            {
+                --current;
+                push_free(block + (MIN_BLOCK << current), current);
+            }
+
+            return m_memory + block;
+        }
+
+        void deallocate(void *ptr, size_type bytes, size_type = ALIGNMENT) noexcept
+        {
+            size_type block = static_cast<size_type>(static_cast<unsigned char *>(ptr) - m_memory);
+            size_type order = order_of(bytes);
+
+            // Freed block is on no list yet, so its pair bit is set exactly when the buddy is free
+            while (order < MAX_ORDER && pair_bit(block, order))
+            {
+                pop_free(block ^ (MIN_BLOCK << order), order);
+                block &= ~(MIN_BLOCK << order);
+                ++order;
+            }
+            push_free(block, order);
+        }
+
+        // Bytes in the biggest free block
+        size_type largest_free_block() const noexcept
+        {
+            return m_free_orders == 0U ? 0U : MIN_BLOCK << (std::bit_width(m_free_orders) - 1U);
+        }
+
+    private:
+        static constexpr size_type MAX_ORDER = std::countr_zero(BYTES / MIN_BLOCK);
+        static constexpr size_type ORDERS = MAX_ORDER + 1U;
+        static constexpr size_type NEXT = 0U;
+        static constexpr size_type PREVIOUS = 1U;
+        static constexpr size_type NONE = std::numeric_limits<size_type>::max();
+        static constexpr size_type WORD_BITS = 64U;
+
+        static_assert(ORDERS <= WORD_BITS, "Orders are tracked in one word");
+
+        // Pair bits of an order follow those of lower orders: BYTES / MIN_BLOCK / 2 + BYTES / MIN_BLOCK / 4 + ...
+        static constexpr size_type pairs_before(size_type order) noexcept
+        {
+            return (BYTES / MIN_BLOCK) - ((BYTES / MIN_BLOCK) >> order);
+        }
+
+        static constexpr size_type PAIR_WORDS = (pairs_before(MAX_ORDER) + WORD_BITS - 1U) / WORD_BITS;
+
+        static constexpr size_type order_of(size_type bytes) noexcept
+        {
+            return static_cast<size_type>(std::countr_zero(std::bit_ceil(bytes < MIN_BLOCK ? MIN_BLOCK : bytes) / MIN_BLOCK));
+        }
+
+        static constexpr size_type pair_index(size_type block, size_type order) noexcept
+        {
+            return pairs_before(order) + block / (MIN_BLOCK << order) / 2U;
+        }
+
+        bool pair_bit(size_type block, size_type order) const noexcept
+        {
+            const size_type index = pair_index(block, order);
+            return ((m_pairs[index / WORD_BITS] >> (index % WORD_BITS)) & 1U) != 0U;
+        }
+
+        void flip_pair_bit(size_type block, size_type order) noexcept
+        {
+            if (order < MAX_ORDER)
+            {
+                const size_type index = pair_index(block, order);
+                m_pairs[index / WORD_BITS] ^= std::uint64_t{1U} << (index % WORD_BITS);
+            }
+        }
+
+        size_type read_link(size_type block, size_type link) const noexcept
+        {
+            size_type value;
+            std::memcpy(&value, m_memory + block + link * sizeof(size_type), sizeof(value));
+            return value;
+        }
+
+        void write_link(size_type block, size_type link, size_type value) noexcept
+        {
+            std::memcpy(m_memory + block + link * sizeof(size_type), &value, sizeof(value));
+        }
+
+        void push_free(size_type block, size_type order) noexcept
+        {
+            const size_type head = m_lists[order];
+            write_link(block, NEXT, head);
+            write_link(block, PREVIOUS, NONE);
+            if (head != NONE)
+            {
+                write_link(head, PREVIOUS, block);
+            }
+            m_lists[order] = block;
+            m_free_orders |= size_type{1U} << order;
+            flip_pair_bit(block, order);
+        }
+
+        void pop_free(size_type block, size_type order) noexcept
+        {
+            const size_type next = read_link(block, NEXT);
+            const size_type previous = read_link(block, PREVIOUS);
+            if (previous != NONE)
+            {
+                write_link(previous, NEXT, next);
+            }
+            else
+            {
+                m_lists[order] = next;
+                if (next == NONE)
+                {
+                    m_free_orders &= ~(size_type{1U} << order);
+                }
+            }
+            if (next != NONE)
+            {
+                write_link(next, PREVIOUS, previous);
+            }
+            flip_pair_bit(block, order);
+        }
+
+        alignas(MIN_BLOCK) unsigned char m_memory[BYTES];
+
+        std::array<size_type, ORDERS> m_lists;
+        std::array<std::uint64_t, PAIR_WORDS == 0U ? 1U : PAIR_WORDS> m_pairs;
+        // Bit k set when the free list of order k is not empty
+        size_type m_free_orders{0U};
+    };
+
+    /**
+     * @brief Custom allocator over a buddy area, owned outside and shared by copies and rebinds.
+     *
+     * @tparam T The type of elements to allocate memory for.
+     * @tparam BYTES Size of the area in bytes, power of two.
+     */
+    template <typename T, std::size_t BYTES = 4096>
+    using Buddy_allocator = Shared_arena_allocator<T, Buddy_arena<BYTES>>;
+
+}
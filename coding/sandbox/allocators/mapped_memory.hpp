@@ -0,0 +1,268 @@
+// Copyright (c) 2024, Piotr Staniszewski
+
+#pragma once
+
+#include <cstddef>
+#include <memory_resource>
+#include <new>
+#include <utility>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#define ALLOCATORS_MAPPED_MEMORY 1
+#else
+#define ALLOCATORS_MAPPED_MEMORY 0
+#endif
+
+// Backing memory for big arenas, mapped straight from the kernel instead of the heap
+namespace backing
+{
+
+    enum class Huge_pages
+    {
+        // Regular 4 KB pages
+        NONE,
+        // madvise(MADV_HUGEPAGE): kernel backs the area with 2 MB pages when it can (THP)
+        TRANSPARENT,
+        // MAP_HUGETLB: pages reserved by the administrator (vm.nr_hugepages), falls back to TRANSPARENT when there are none
+        EXPLICIT
+    };
+
+    struct Options
+    {
+        Huge_pages m_huge_pages{Huge_pages::TRANSPARENT};
+        // Prefer the NUMA node of the calling thread with mbind(MPOL_PREFERRED), pages are still taken
+        // from other nodes when the local one is full
+        bool m_local_node{true};
+    };
+
+    /**
+     * @brief Anonymous memory mapping, released with the object.
+     *
+     * Every optional step (huge pages, NUMA binding) that the system refuses is skipped, the mapping
+     * still works; what was granted can be checked afterwards. Without mmap (not Linux) the memory
+     * comes from operator new. Size is rounded up to the page size (2 MB for huge pages).
+     */
+    class Mapped_memory
+    {
+    public:
+        static constexpr std::size_t PAGE_SIZE = 4096U;
+        static constexpr std::size_t HUGE_PAGE_SIZE = 2U * 1024U * 1024U;
+
+        explicit Mapped_memory(std::size_t bytes, Options options = {}) : m_size{mapped_size(bytes, options)}
+        {
+            const bool huge = options.m_huge_pages != Huge_pages::NONE;
+
+#if ALLOCATORS_MAPPED_MEMORY
+            if (options.m_huge_pages == Huge_pages::EXPLICIT)
+            {
+                m_data = map(MAP_HUGETLB);
+                m_explicit_huge_pages = m_data != nullptr;
+            }
+            if (m_data == nullptr)
+            {
+                m_data = map(0);
+            }
+            if (m_data == nullptr)
+            {
+                throw std::bad_alloc();
+            }
+
+            if (huge && !m_explicit_huge_pages)
+            {
+                m_transparent_huge_pages = ::madvise(m_data, m_size, MADV_HUGEPAGE) == 0;
+            }
+            if (options.m_local_node)
+            {
+                bind_to_local_node();
+            }
+#else
+            m_data = ::operator new(m_size, std::align_val_t{PAGE_SIZE});
+#endif
+        }
+
+        Mapped_memory(const Mapped_memory &) = delete;
+        Mapped_memory &operator=(const Mapped_memory &) = delete;
+
+        Mapped_memory(Mapped_memory &&other) noexcept
+            : m_data{std::exchange(other.m_data, nullptr)}, m_size{std::exchange(other.m_size, 0U)}, m_explicit_huge_pages{other.m_explicit_huge_pages}, m_transparent_huge_pages{other.m_transparent_huge_pages}, m_numa_node{other.m_numa_node}
+        {
+        }
+
+        Mapped_memory &operator=(Mapped_memory &&other) noexcept
+        {
+            if (this != &other)
+            {
+                release();
+                m_data = std::exchange(other.m_data, nullptr);
+                m_size = std::exchange(other.m_size, 0U);
+                m_explicit_huge_pages = other.m_explicit_huge_pages;
+                m_transparent_huge_pages = other.m_transparent_huge_pages;
+                m_numa_node = other.m_numa_node;
+            }
+            return *this;
+        }
+
+        ~Mapped_memory() noexcept
+        {
+            release();
+        }
+
+        void *data() const noexcept { return m_data; }
+        std::size_t size() const noexcept { return m_size; }
+        bool explicit_huge_pages() const noexcept { return m_explicit_huge_pages; }
+        bool transparent_huge_pages() const noexcept { return m_transparent_huge_pages; }
+        // -1 when not bound
+        int numa_node() const noexcept { return m_numa_node; }
+
+        // Size of the mapping made for a request of bytes
+        static constexpr std::size_t mapped_size(std::size_t bytes, Options options) noexcept
+        {
+            const std::size_t page = options.m_huge_pages != Huge_pages::NONE ? HUGE_PAGE_SIZE : PAGE_SIZE;
+            return (bytes + page - 1U) / page * page;
+        }
+
+        // Ownership of the memory passes to the caller, to be given back to unmap() with mapped_size() of the request
+        void *detach() noexcept
+        {
+            m_size = 0U;
+            return std::exchange(m_data, nullptr);
+        }
+
+        static void unmap(void *data, std::size_t size) noexcept
+        {
+#if ALLOCATORS_MAPPED_MEMORY
+            ::munmap(data, size);
+#else
+            static_cast<void>(size);
+            ::operator delete(data, std::align_val_t{PAGE_SIZE});
+#endif
+        }
+
+    private:
+#if ALLOCATORS_MAPPED_MEMORY
+        void *map(int flags) noexcept
+        {
+            void *data = ::mmap(nullptr, m_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | flags, -1, 0);
+            return data == MAP_FAILED ? nullptr : data;
+        }
+
+        // Raw system calls: <numaif.h> wrappers need libnuma, which may not be installed
+        void bind_to_local_node() noexcept
+        {
+#if defined(SYS_mbind) && defined(SYS_getcpu)
+            // MPOL_PREFERRED from <numaif.h>
+            constexpr int MPOL_PREFERRED_POLICY = 1;
+
+            unsigned cpu{0U};
+            unsigned node{0U};
+            if (::syscall(SYS_getcpu, &cpu, &node, nullptr) != 0)
+            {
+                return;
+            }
+            constexpr std::size_t MASK_BITS = 8U * sizeof(unsigned long);
+            if (node >= MASK_BITS)
+            {
+                return;
+            }
+            const unsigned long node_mask = 1UL << node;
+            if (::syscall(SYS_mbind, m_data, m_size, MPOL_PREFERRED_POLICY, &node_mask, MASK_BITS, 0U) == 0)
+            {
+                m_numa_node = static_cast<int>(node);
+            }
+#endif
+        }
+#endif
+
+        void release() noexcept
+        {
+            if (m_data == nullptr)
+            {
+                return;
+            }
+            unmap(m_data, m_size);
+            m_data = nullptr;
+        }
+
+        void *m_data{nullptr};
+        std::size_t m_size{0U};
+        bool m_explicit_huge_pages{false};
+        bool m_transparent_huge_pages{false};
+        int m_numa_node{-1};
+    };
+
+    /**
+     * @brief Memory resource mapping every allocation separately, meant as upstream of arenas
+     * (e.g. medium::Monotonic_arena) that ask for few big chunks. Nothing is kept besides the mapping:
+     * the size given back on deallocation tells how much to unmap.
+     */
+    class Mapped_resource : public std::pmr::memory_resource
+    {
+    public:
+        explicit Mapped_resource(Options options = {}) noexcept : m_options{options}
+        {
+        }
+
+    protected:
+        void *do_allocate(std::size_t bytes, std::size_t alignment) override
+        {
+            if (alignment > Mapped_memory::PAGE_SIZE)
+            {
+                throw std::bad_alloc();
+            }
+            return Mapped_memory{bytes, m_options}.detach();
+        }
+
+        void do_deallocate(void *ptr, std::size_t bytes, std::size_t) override
+        {
+            Mapped_memory::unmap(ptr, Mapped_memory::mapped_size(bytes, m_options));
+        }
+
+        bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override
+        {
+            return this == &other;
+        }
+
+    private:
+        Options m_options;
+    };
+
+    /**
+     * @brief Object constructed inside its own mapping, for arenas with the memory inside
+     * (complex::Boundary_tag_arena, complex::Safe_allocator) too big for the stack or the heap.
+     *
+     * @tparam T The type of the object.
+     */
+    template <typename T>
+    class Mapped_object
+    {
+    public:
+        template <typename... Args>
+        explicit Mapped_object(Options options, Args &&...args) : m_memory{sizeof(T), options}
+        {
+            static_assert(alignof(T) <= Mapped_memory::PAGE_SIZE, "Mapping is page aligned");
+            m_object = new (m_memory.data()) T(std::forward<Args>(args)...);
+        }
+
+        Mapped_object(const Mapped_object &) = delete;
+        Mapped_object &operator=(const Mapped_object &) = delete;
+
+        ~Mapped_object() noexcept
+        {
+            m_object->~T();
+        }
+
+        T &operator*() const noexcept { return *m_object; }
+        T *operator->() const noexcept { return m_object; }
+        T *get() const noexcept { return m_object; }
+
+        const Mapped_memory &memory() const noexcept { return m_memory; }
+
+    private:
+        Mapped_memory m_memory;
+        T *m_object;
+    };
+
+}
@@ -0,0 +1,188 @@
+// Copyright (c) 2024, Piotr Staniszewski
+
+#pragma once
+
+#include <cstddef>
+#include <limits>
+#include <new>
+#include <type_traits>
+
+namespace medium
+{
+
+    /**
+     * @brief Pool of blocks of a single size, carved out of big slabs.
+     *
+     * Freed blocks are linked through their own memory (intrusive free list), new slab is taken only
+     * when the free list is empty and the current slab is used up, so both allocate and deallocate are O(1).
+     * Slabs are chained the same way and released only with the pool. Not thread-safe.
+     */
+    class Slab_pool
+    {
+    public:
+        static constexpr std::size_t SLAB_SIZE = 64U * 1024U;
+
+        explicit Slab_pool(std::size_t block_size) noexcept : m_block_size{block_size}
+        {
+        }
+
+        Slab_pool(const Slab_pool &) = delete;
+        Slab_pool &operator=(const Slab_pool &) = delete;
+
+        ~Slab_pool() noexcept
+        {
+            while (m_slabs != nullptr)
+            {
+                Slab *previous = m_slabs->m_previous;
+                ::operator delete(m_slabs, std::align_val_t{alignof(std::max_align_t)});
+                m_slabs = previous;
+            }
+        }
+
+        [[nodiscard]] void *allocate()
+        {
+            if (m_free != nullptr)
+            {
+                Free_block *block = m_free;
+                m_free = block->m_next;
+                return block;
+            }
+
+            if (m_next == m_end)
+            {
+                add_slab();
+            }
+            void *block = m_next;
+            m_next += m_block_size;
+            return block;
+        }
+
+        void deallocate(void *ptr) noexcept
+        {
+            auto *block = static_cast<Free_block *>(ptr);
+            block->m_next = m_free;
+            m_free = block;
+        }
+
+        std::size_t block_size() const noexcept
+        {
+            return m_block_size;
+        }
+
+    private:
+        struct Free_block
+        {
+            Free_block *m_next;
+        };
+
+        // Header of a slab, blocks follow
+        struct alignas(std::max_align_t) Slab
+        {
+            Slab *m_previous;
+        };
+
+        void add_slab()
+        {
+            auto *slab = static_cast<Slab *>(::operator new(SLAB_SIZE, std::align_val_t{alignof(std::max_align_t)}));
+            slab->m_previous = m_slabs;
+            m_slabs = slab;
+
+            auto *begin = reinterpret_cast<unsigned char *>(slab) + sizeof(Slab);
+            const std::size_t blocks = (SLAB_SIZE - sizeof(Slab)) / m_block_size;
+            m_next = begin;
+            m_end = begin + blocks * m_block_size;
+        }
+
+        std::size_t m_block_size;
+        Free_block *m_free{nullptr};
+        Slab *m_slabs{nullptr};
+        unsigned char *m_next{nullptr};
+        unsigned char *m_end{nullptr};
+    };
+
+    // Blocks are multiples of the fundamental alignment, up to MAX_POOLED_SIZE
+    inline constexpr std::size_t POOL_GRANULARITY = alignof(std::max_align_t);
+    inline constexpr std::size_t MAX_POOLED_SIZE = 256U;
+
+    constexpr std::size_t size_class(std::size_t size) noexcept
+    {
+        return (size + POOL_GRANULARITY - 1U) / POOL_GRANULARITY * POOL_GRANULARITY;
+    }
+
+    // One pool per size class, shared by all allocators of types of that size. Never destroyed: a pool
+    // created on the first insert into a global container would be destroyed before that container
+    template <std::size_t BLOCK_SIZE>
+    Slab_pool &slab_pool()
+    {
+        static Slab_pool &pool = *new Slab_pool{BLOCK_SIZE};
+        return pool;
+    }
+
+    /**
+     * @brief Custom allocator for node-based containers (std::map, std::set, std::list).
+     *
+     * Single objects come from the pool of their size class, anything else from operator new.
+     * The allocator has no state of its own, so copies and rebinds (a map allocates its nodes through
+     * the allocator rebound to the node type) all share the pools and compare equal.
+     * Pools are process-wide and not synchronized: all containers using the allocator must live in one thread
+     * (concurrent::Thread_caching_allocator is the thread-safe alternative).
+     *
+     * @tparam T The type of elements to allocate memory for.
+     */
+    template <typename T>
+    class Pool_allocator
+    {
+    public:
+        using value_type = T;
+        using size_type = std::size_t;
+        using difference_type = std::ptrdiff_t;
+        using is_always_equal = std::true_type;
+
+        Pool_allocator() noexcept = default;
+
+        template <typename U>
+        Pool_allocator(const Pool_allocator<U> &) noexcept
+        {
+        }
+
+        [[nodiscard]] T *allocate(size_type n)
+        {
+            if constexpr (POOLED)
+            {
+                if (n == 1U)
+                {
+                    return static_cast<T *>(slab_pool<BLOCK_SIZE>().allocate());
+                }
+            }
+            if (n > std::numeric_limits<size_type>::max() / sizeof(T))
+            {
+                throw std::bad_alloc();
+            }
+            return static_cast<T *>(::operator new(n * sizeof(T), std::align_val_t{alignof(T)}));
+        }
+
+        void deallocate(T *ptr, size_type n) noexcept
+        {
+            if constexpr (POOLED)
+            {
+                if (n == 1U)
+                {
+                    slab_pool<BLOCK_SIZE>().deallocate(ptr);
+                    return;
+                }
+            }
+            ::operator delete(ptr, std::align_val_t{alignof(T)});
+        }
+
+    private:
+        static constexpr size_type BLOCK_SIZE = size_class(sizeof(T));
+        static constexpr bool POOLED = BLOCK_SIZE <= MAX_POOLED_SIZE && alignof(T) <= POOL_GRANULARITY;
+    };
+
+    template <typename T, typename U>
+    bool operator==(const Pool_allocator<T> &, const Pool_allocator<U> &) noexcept
+    {
+        return true;
+    }
+
+}
@@ -0,0 +1,82 @@
+// Copyright (c) 2024, Piotr Staniszewski
+
+#pragma once
+
+#include <cstddef>
+#include <limits>
+#include <new>
+#include <type_traits>
+
+namespace complex
+{
+
+    /**
+     * @brief Custom allocator that refers to an arena living outside of it.
+     *
+     * The allocator is only a handle (pointer) to the arena, so copies and rebinds made by containers
+     * all allocate from the same memory and compare equal. Allocators of different arenas compare unequal,
+     * so the allocator moves with the memory: on move assignment and swap the target container takes
+     * the source's allocator and buffers instead of copying element by element into its own arena, on copy
+     * assignment it adopts the source's arena. The arena must outlive all containers using it.
+     *
+     * Arena is any type with allocate(bytes, alignment) and deallocate(ptr, bytes, alignment),
+     * e.g. Boundary_tag_arena, medium::Monotonic_arena or any std::pmr::memory_resource.
+     *
+     * @tparam T The type of elements to allocate memory for.
+     * @tparam Arena The type of the shared arena.
+     */
+    template <typename T, typename Arena>
+    class Shared_arena_allocator
+    {
+    public:
+        using value_type = T;
+        using size_type = std::size_t;
+        using difference_type = std::ptrdiff_t;
+        using propagate_on_container_copy_assignment = std::true_type;
+        using propagate_on_container_move_assignment = std::true_type;
+        using propagate_on_container_swap = std::true_type;
+        using is_always_equal = std::false_type;
+
+        explicit Shared_arena_allocator(Arena &arena) noexcept : m_arena{&arena}
+        {
+        }
+
+        template <typename U>
+        Shared_arena_allocator(const Shared_arena_allocator<U, Arena> &other) noexcept : m_arena{other.m_arena}
+        {
+        }
+
+        [[nodiscard]] T *allocate(size_type n)
+        {
+            if (n > std::numeric_limits<size_type>::max() / sizeof(T))
+            {
+                throw std::bad_alloc();
+            }
+            return static_cast<T *>(m_arena->allocate(n * sizeof(T), alignof(T)));
+        }
+
+        void deallocate(T *ptr, size_type n) noexcept
+        {
+            m_arena->deallocate(ptr, n * sizeof(T), alignof(T));
+        }
+
+        Arena &arena() const noexcept
+        {
+            return *m_arena;
+        }
+
+    private:
+        template <typename U, typename>
+        friend class Shared_arena_allocator;
+
+        Arena *m_arena;
+    };
+
+    // Equal allocators share the arena, whatever the element type
+    template <typename T, typename U, typename Arena>
+    bool operator==(const Shared_arena_allocator<T, Arena> &lhs, const Shared_arena_allocator<U, Arena> &rhs) noexcept
+    {
+        return &lhs.arena() == &rhs.arena();
+    }
+
+}
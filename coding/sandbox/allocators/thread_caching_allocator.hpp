@@ -0,0 +1,482 @@
+// Copyright (c) 2024, Piotr Staniszewski
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <limits>
+#include <new>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace concurrent
+{
+
+    // Blocks of 16, 32, ... 256 bytes are cached, bigger ones go to operator new
+    inline constexpr std::size_t CACHE_GRANULARITY = 16U;
+    inline constexpr std::size_t MAX_CACHED_SIZE = 256U;
+    inline constexpr std::size_t SIZE_CLASSES = MAX_CACHED_SIZE / CACHE_GRANULARITY;
+    inline constexpr std::size_t MAGAZINE_SIZE = 64U;
+    inline constexpr std::size_t CACHE_SLAB_SIZE = 64U * 1024U;
+
+    constexpr std::size_t cache_size_class(std::size_t bytes) noexcept
+    {
+        return (bytes + CACHE_GRANULARITY - 1U) / CACHE_GRANULARITY - 1U;
+    }
+
+    // Fixed number of free blocks of one size class, moved between threads as a whole
+    struct Magazine
+    {
+        bool empty() const noexcept { return m_count == 0U; }
+        bool full() const noexcept { return m_count == MAGAZINE_SIZE; }
+
+        std::atomic<Magazine *> m_next{nullptr};
+        Magazine *m_all_next{nullptr};
+        std::size_t m_count{0U};
+        void *m_blocks[MAGAZINE_SIZE];
+    };
+
+    // Block freed when no magazine could take it, linked through its own memory
+    struct Orphan
+    {
+        Orphan *m_next;
+    };
+
+    /**
+     * @brief Lock-free LIFO of magazines (Treiber stack).
+     *
+     * Head pointer is packed with a 16-bit version into one 64-bit word, so a head popped and pushed
+     * back in between doesn't fool the compare-and-swap (ABA). Magazines are never freed while threads run,
+     * so reading the next link of a head just popped by another thread is harmless.
+     */
+    class Magazine_stack
+    {
+    public:
+        static_assert(sizeof(void *) == 8U, "Pointers are packed into 48 bits");
+
+        void push(Magazine *magazine) noexcept
+        {
+            auto head = m_head.load(std::memory_order_relaxed);
+            do
+            {
+                magazine->m_next.store(pointer(head), std::memory_order_relaxed);
+            } while (!m_head.compare_exchange_weak(head, pack(magazine, version(head) + 1U), std::memory_order_release, std::memory_order_relaxed));
+        }
+
+        Magazine *pop() noexcept
+        {
+            auto head = m_head.load(std::memory_order_acquire);
+            while (pointer(head) != nullptr)
+            {
+                Magazine *next = pointer(head)->m_next.load(std::memory_order_relaxed);
+                if (m_head.compare_exchange_weak(head, pack(next, version(head) + 1U), std::memory_order_acquire, std::memory_order_acquire))
+                {
+                    return pointer(head);
+                }
+            }
+            return nullptr;
+        }
+
+    private:
+        static constexpr std::uint64_t POINTER_MASK = (std::uint64_t{1U} << 48U) - 1U;
+
+        static Magazine *pointer(std::uint64_t word) noexcept { return reinterpret_cast<Magazine *>(word & POINTER_MASK); }
+
+        static std::uint64_t version(std::uint64_t word) noexcept { return word >> 48U; }
+
+        static std::uint64_t pack(Magazine *magazine, std::uint64_t version) noexcept
+        {
+            return (reinterpret_cast<std::uint64_t>(magazine) & POINTER_MASK) | (version << 48U);
+        }
+
+        std::atomic<std::uint64_t> m_head{0U};
+    };
+
+    /**
+     * @brief Global depot: full magazines per size class and empty magazines, shared by all threads.
+     *
+     * Threads come here only when both their magazines of a class are empty (allocation) or full (deallocation),
+     * once per MAGAZINE_SIZE operations at most. Blocks freed when no empty magazine is left become orphans,
+     * pushed without allocating and taken back all at once by allocations. The depot is never destroyed:
+     * containers with static storage duration free their blocks after static destructors have run.
+     */
+    class Depot
+    {
+    public:
+        static Depot &instance()
+        {
+            static Depot &depot = *new Depot;
+            return depot;
+        }
+
+        Depot(const Depot &) = delete;
+        Depot &operator=(const Depot &) = delete;
+
+        Magazine *pop_full(std::size_t size_class) noexcept
+        {
+            return m_full[size_class].pop();
+        }
+
+        void push_full(std::size_t size_class, Magazine *magazine) noexcept
+        {
+            m_full[size_class].push(magazine);
+        }
+
+        // nullptr when there are no empty magazines, see new_magazine()
+        Magazine *pop_empty() noexcept
+        {
+            return m_empty.pop();
+        }
+
+        void push_empty(Magazine *magazine) noexcept
+        {
+            m_empty.push(magazine);
+        }
+
+        Magazine *new_magazine()
+        {
+            auto *magazine = new Magazine;
+            magazine->m_all_next = m_all_magazines.load(std::memory_order_relaxed);
+            while (!m_all_magazines.compare_exchange_weak(magazine->m_all_next, magazine, std::memory_order_release, std::memory_order_relaxed))
+            {
+            }
+            return magazine;
+        }
+
+        // Chain first .. last in one step, nothing to allocate
+        void push_orphans(std::size_t size_class, Orphan *first, Orphan *last) noexcept
+        {
+            Orphan *head = m_orphans[size_class].load(std::memory_order_relaxed);
+            do
+            {
+                last->m_next = head;
+            } while (!m_orphans[size_class].compare_exchange_weak(head, first, std::memory_order_release, std::memory_order_relaxed));
+        }
+
+        void push_orphan(std::size_t size_class, void *ptr) noexcept
+        {
+            auto *orphan = static_cast<Orphan *>(ptr);
+            push_orphans(size_class, orphan, orphan);
+        }
+
+        // Whole list at once, so there is no ABA problem as with popping single blocks
+        Orphan *take_orphans(std::size_t size_class) noexcept
+        {
+            return m_orphans[size_class].exchange(nullptr, std::memory_order_acquire);
+        }
+
+        // Blocks are carved by threads, the depot only keeps the slabs
+        std::pair<unsigned char *, unsigned char *> new_slab()
+        {
+            auto *slab = static_cast<Slab *>(::operator new(CACHE_SLAB_SIZE, std::align_val_t{CACHE_GRANULARITY}));
+            slab->m_next = m_slabs.load(std::memory_order_relaxed);
+            while (!m_slabs.compare_exchange_weak(slab->m_next, slab, std::memory_order_release, std::memory_order_relaxed))
+            {
+            }
+            auto *begin = reinterpret_cast<unsigned char *>(slab);
+            return {begin + sizeof(Slab), begin + CACHE_SLAB_SIZE};
+        }
+
+        // For a thread whose cache is already destroyed (thread or process exit)
+        [[nodiscard]] void *allocate(std::size_t size_class)
+        {
+            if (Magazine *full = pop_full(size_class))
+            {
+                void *block = full->m_blocks[--full->m_count];
+                if (full->empty())
+                {
+                    push_empty(full);
+                }
+                else
+                {
+                    push_full(size_class, full);
+                }
+                return block;
+            }
+            if (Orphan *orphans = take_orphans(size_class))
+            {
+                if (orphans->m_next != nullptr)
+                {
+                    Orphan *last = orphans->m_next;
+                    while (last->m_next != nullptr)
+                    {
+                        last = last->m_next;
+                    }
+                    push_orphans(size_class, orphans->m_next, last);
+                }
+                return orphans;
+            }
+
+            // Rest of a new slab becomes orphans
+            const std::size_t block_size = (size_class + 1U) * CACHE_GRANULARITY;
+            auto [begin, end] = new_slab();
+            auto *first = reinterpret_cast<Orphan *>(begin + block_size);
+            Orphan *last = first;
+            for (unsigned char *next = begin + 2U * block_size; next + block_size <= end; next += block_size)
+            {
+                last->m_next = reinterpret_cast<Orphan *>(next);
+                last = last->m_next;
+            }
+            push_orphans(size_class, first, last);
+            return begin;
+        }
+
+    private:
+        struct alignas(CACHE_GRANULARITY) Slab
+        {
+            Slab *m_next;
+        };
+
+        Depot() = default;
+
+        std::array<Magazine_stack, SIZE_CLASSES> m_full;
+        Magazine_stack m_empty;
+        std::array<std::atomic<Orphan *>, SIZE_CLASSES> m_orphans{};
+        // Everything ever allocated stays reachable through plain pointers (stack heads are packed)
+        std::atomic<Magazine *> m_all_magazines{nullptr};
+        std::atomic<Slab *> m_slabs{nullptr};
+    };
+
+    /**
+     * @brief Per-thread cache: two magazines per size class, no synchronization on the fast path.
+     *
+     * Allocation takes from the loaded magazine, then from the previous one, then swaps in a full magazine
+     * from the depot, then takes orphans and only then carves new blocks. Deallocation mirrors it with empty
+     * magazines and never allocates: with no empty magazine in the depot the block becomes an orphan.
+     * Keeping two magazines stops a thread alternating around a boundary from going to the depot every time.
+     */
+    class Thread_cache
+    {
+    public:
+        // nullptr once the cache of the calling thread is destroyed
+        static Thread_cache *instance()
+        {
+            if (m_destroyed)
+            {
+                return nullptr;
+            }
+            thread_local Thread_cache cache;
+            return &cache;
+        }
+
+        Thread_cache(const Thread_cache &) = delete;
+        Thread_cache &operator=(const Thread_cache &) = delete;
+
+        // Magazines and orphans of an exiting thread go back to the depot, with blocks still in them
+        ~Thread_cache() noexcept
+        {
+            for (std::size_t size_class = 0U; size_class < SIZE_CLASSES; ++size_class)
+            {
+                auto &cache = m_classes[size_class];
+                for (Magazine *magazine : {cache.m_loaded, cache.m_previous})
+                {
+                    if (magazine == nullptr)
+                    {
+                        continue;
+                    }
+                    if (magazine->empty())
+                    {
+                        m_depot.push_empty(magazine);
+                    }
+                    else
+                    {
+                        m_depot.push_full(size_class, magazine);
+                    }
+                }
+                if (cache.m_orphans != nullptr)
+                {
+                    Orphan *last = cache.m_orphans;
+                    while (last->m_next != nullptr)
+                    {
+                        last = last->m_next;
+                    }
+                    m_depot.push_orphans(size_class, cache.m_orphans, last);
+                }
+            }
+            m_destroyed = true;
+        }
+
+        [[nodiscard]] void *allocate(std::size_t size_class)
+        {
+            auto &cache = m_classes[size_class];
+            if (cache.m_loaded != nullptr && !cache.m_loaded->empty())
+            {
+                return cache.m_loaded->m_blocks[--cache.m_loaded->m_count];
+            }
+            if (cache.m_previous != nullptr && !cache.m_previous->empty())
+            {
+                std::swap(cache.m_loaded, cache.m_previous);
+                return cache.m_loaded->m_blocks[--cache.m_loaded->m_count];
+            }
+
+            // Both magazines exist from the first slow allocation on, so deallocation has room
+            for (Magazine **magazine : {&cache.m_loaded, &cache.m_previous})
+            {
+                if (*magazine == nullptr)
+                {
+                    *magazine = m_depot.pop_empty();
+                }
+                if (*magazine == nullptr)
+                {
+                    *magazine = m_depot.new_magazine();
+                }
+            }
+
+            if (Magazine *full = m_depot.pop_full(size_class))
+            {
+                m_depot.push_empty(cache.m_loaded);
+                cache.m_loaded = full;
+                return cache.m_loaded->m_blocks[--cache.m_loaded->m_count];
+            }
+            if (cache.m_orphans == nullptr)
+            {
+                cache.m_orphans = m_depot.take_orphans(size_class);
+            }
+            if (cache.m_orphans != nullptr)
+            {
+                Orphan *orphan = cache.m_orphans;
+                cache.m_orphans = orphan->m_next;
+                return orphan;
+            }
+            return carve(size_class);
+        }
+
+        void deallocate(std::size_t size_class, void *ptr) noexcept
+        {
+            auto &cache = m_classes[size_class];
+            if (cache.m_loaded == nullptr || cache.m_loaded->full())
+            {
+                // Previous magazine missing or holding blocks: trade it for an empty one
+                if (cache.m_previous == nullptr || !cache.m_previous->empty())
+                {
+                    Magazine *empty = m_depot.pop_empty();
+                    if (empty == nullptr)
+                    {
+                        m_depot.push_orphan(size_class, ptr);
+                        return;
+                    }
+                    if (cache.m_previous != nullptr)
+                    {
+                        m_depot.push_full(size_class, cache.m_previous);
+                    }
+                    cache.m_previous = empty;
+                }
+                std::swap(cache.m_loaded, cache.m_previous);
+            }
+            cache.m_loaded->m_blocks[cache.m_loaded->m_count++] = ptr;
+        }
+
+    private:
+        struct Class_cache
+        {
+            Magazine *m_loaded{nullptr};
+            Magazine *m_previous{nullptr};
+            // Orphans taken from the depot, used before carving
+            Orphan *m_orphans{nullptr};
+            // Not yet used part of the last slab of this class
+            unsigned char *m_next{nullptr};
+            unsigned char *m_end{nullptr};
+        };
+
+        Thread_cache() : m_depot{Depot::instance()}
+        {
+        }
+
+        void *carve(std::size_t size_class)
+        {
+            auto &cache = m_classes[size_class];
+            const std::size_t block_size = (size_class + 1U) * CACHE_GRANULARITY;
+            if (static_cast<std::size_t>(cache.m_end - cache.m_next) < block_size)
+            {
+                std::tie(cache.m_next, cache.m_end) = m_depot.new_slab();
+            }
+            void *block = cache.m_next;
+            cache.m_next += block_size;
+            return block;
+        }
+
+        // Trivially destructible, still readable while other thread_local and static objects are destroyed
+        static inline thread_local bool m_destroyed{false};
+
+        Depot &m_depot;
+        std::array<Class_cache, SIZE_CLASSES> m_classes{};
+    };
+
+    /**
+     * @brief Custom allocator with thread caching, safe to use from many threads.
+     *
+     * Blocks up to MAX_CACHED_SIZE bytes come from the cache of the calling thread, others from operator new.
+     * A block may be freed by another thread than the one that allocated it, it then joins that thread's cache.
+     * Deallocation never throws; containers with static or thread storage duration may outlive the caches.
+     * The allocator has no state of its own, copies and rebinds compare equal.
+     *
+     * @tparam T The type of elements to allocate memory for.
+     */
+    template <typename T>
+    class Thread_caching_allocator
+    {
+    public:
+        using value_type = T;
+        using size_type = std::size_t;
+        using difference_type = std::ptrdiff_t;
+        using is_always_equal = std::true_type;
+
+        Thread_caching_allocator() noexcept = default;
+
+        template <typename U>
+        Thread_caching_allocator(const Thread_caching_allocator<U> &) noexcept
+        {
+        }
+
+        [[nodiscard]] T *allocate(size_type n)
+        {
+            if (n > std::numeric_limits<size_type>::max() / sizeof(T))
+            {
+                throw std::bad_alloc();
+            }
+            if (cached(n))
+            {
+                if (Thread_cache *cache = Thread_cache::instance())
+                {
+                    return static_cast<T *>(cache->allocate(cache_size_class(n * sizeof(T))));
+                }
+                return static_cast<T *>(Depot::instance().allocate(cache_size_class(n * sizeof(T))));
+            }
+            return static_cast<T *>(::operator new(n * sizeof(T), std::align_val_t{alignof(T)}));
+        }
+
+        void deallocate(T *ptr, size_type n) noexcept
+        {
+            if (cached(n))
+            {
+                if (Thread_cache *cache = Thread_cache::instance())
+                {
+                    cache->deallocate(cache_size_class(n * sizeof(T)), ptr);
+                }
+                else
+                {
+                    Depot::instance().push_orphan(cache_size_class(n * sizeof(T)), ptr);
+                }
+                return;
+            }
+            ::operator delete(ptr, std::align_val_t{alignof(T)});
+        }
+
+    private:
+        static constexpr bool cached(size_type n) noexcept
+        {
+            return alignof(T) <= CACHE_GRANULARITY && n != 0U && n <= MAX_CACHED_SIZE / sizeof(T);
+        }
+    };
+
+    template <typename T, typename U>
+    bool operator==(const Thread_caching_allocator<T> &, const Thread_caching_allocator<U> &) noexcept
+    {
+        return true;
+    }
+
+}